@@ -0,0 +1,553 @@
+// Headless frame-time benchmark
+// Renders a procedurally scaled scene along a scripted camera path without SFML
+// and reports per-frame latency statistics.
+//
+// Usage: ./bench_frame [--copies N] [--frames N] [--warmup N] [--size WxH]
+//                      [--mesh path.obj] [--mode light|mesh] [--ppm-dir dir]
+//                      [--ppm-every N] [--threads N] [--occlusion] [--scene]
+//                      [--cache] [--optimize] [--lod] [--instanced] [--pipeline N]
+//                      [--present-ms MS] [--stats-csv path.csv] [--trace path.json]
+//                      [--texture checker|path.ppm] [--walls] [--verbose]
+//
+// --texture maps a texture onto meshes with texture coordinates in light mode,
+// e.g. --mesh assets/textured_cube.obj --texture checker
+//
+// --walls adds two tall occluder walls crossing at the scene center, so that
+// part of the grid is hidden from every point of the orbit; compare a run
+// with and without --occlusion, the frame checksums must match in light mode.
+// Mesh mode draws edges with a depth bias that lets those of meshes just
+// behind a wall show through it, so culling them changes that image.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include "Camera.hpp"
+#include "FramePipeline.hpp"
+#include "FrameStats.hpp"
+#include "Light.hpp"
+#include "Material.hpp"
+#include "Mesh.hpp"
+#include "MeshCache.hpp"
+#include "MeshOptimizer.hpp"
+#include "MeshSimplifier.hpp"
+#include "Renderer.hpp"
+#include "Scene.hpp"
+#include "Texture.hpp"
+#include "Trace.hpp"
+
+struct BenchOptions {
+    int copies = 64;
+    int frames = 200;
+    int warmup = 10;
+    int width = 800;
+    int height = 600;
+    std::string meshPath = "assets/cube.obj";
+    bool lighting = true;
+    std::string ppmDir;
+    int ppmEvery = 0;
+    int threads = 0;        // 0 = one per hardware core
+    bool occlusion = false;
+    bool useScene = false;  // Render through a Scene (BVH) instead of the mesh vector
+    bool useCache = false;  // Load the mesh through the binary mesh cache
+    bool optimize = false;  // Run MeshOptimizer on the loaded mesh
+    bool lod = false;       // Generate levels of detail for the loaded mesh
+    bool instanced = false; // Draw one geometry with per-instance transforms
+    bool walls = false;     // Add two occluder walls through the scene center
+    int pipelineBuffers = 0;    // Render through a FramePipeline with this many buffers (0 = serial)
+    double presentMs = 0.0;     // Simulated presentation time per frame
+    std::string statsPath;      // Per-frame FrameStats CSV
+    std::string tracePath;      // Chrome trace of loading and the measured frames
+    std::string texturePath;    // PPM image, or "checker" for a generated texture
+    bool verbose = false;
+};
+
+static void printUsage(const char* program) {
+    printf("Usage: %s [--copies N] [--frames N] [--warmup N] [--size WxH]\n"
+           "          [--mesh path.obj] [--mode light|mesh] [--ppm-dir dir]\n"
+           "          [--ppm-every N] [--threads N] [--occlusion] [--scene]\n"
+           "          [--cache] [--optimize] [--lod] [--instanced] [--pipeline N]\n"
+           "          [--present-ms MS] [--stats-csv path.csv] [--trace path.json]\n"
+           "          [--texture checker|path.ppm] [--walls] [--verbose]\n", program);
+}
+
+static bool parseOptions(int argc, char** argv, BenchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--copies" && hasValue) {
+            options.copies = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--frames" && hasValue) {
+            options.frames = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--warmup" && hasValue) {
+            options.warmup = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--size" && hasValue) {
+            if (std::sscanf(argv[++i], "%dx%d", &options.width, &options.height) != 2 ||
+                options.width <= 0 || options.height <= 0) {
+                return false;
+            }
+        } else if (arg == "--mesh" && hasValue) {
+            options.meshPath = argv[++i];
+        } else if (arg == "--mode" && hasValue) {
+            std::string mode = argv[++i];
+            if (mode != "light" && mode != "mesh") return false;
+            options.lighting = (mode == "light");
+        } else if (arg == "--ppm-dir" && hasValue) {
+            options.ppmDir = argv[++i];
+            if (options.ppmEvery == 0) options.ppmEvery = 1;
+        } else if (arg == "--ppm-every" && hasValue) {
+            options.ppmEvery = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--threads" && hasValue) {
+            options.threads = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--optimize") {
+            options.optimize = true;
+        } else if (arg == "--lod") {
+            options.lod = true;
+        } else if (arg == "--instanced") {
+            options.instanced = true;
+        } else if (arg == "--occlusion") {
+            options.occlusion = true;
+        } else if (arg == "--walls") {
+            options.walls = true;
+        } else if (arg == "--scene") {
+            options.useScene = true;
+        } else if (arg == "--cache") {
+            options.useCache = true;
+        } else if (arg == "--pipeline" && hasValue) {
+            options.pipelineBuffers = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--present-ms" && hasValue) {
+            options.presentMs = std::max(0.0, std::atof(argv[++i]));
+        } else if (arg == "--stats-csv" && hasValue) {
+            options.statsPath = argv[++i];
+        } else if (arg == "--trace" && hasValue) {
+            options.tracePath = argv[++i];
+        } else if (arg == "--texture" && hasValue) {
+            options.texturePath = argv[++i];
+        } else if (arg == "--verbose") {
+            options.verbose = true;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 256x256 checkerboard of 32-texel squares whose colors shift across the image,
+// so both texel detail and the mip levels are visible
+static bool makeCheckerTexture(Texture& texture) {
+    const int size = 256;
+    const int square = 32;
+    std::vector<std::uint32_t> rgba(size * size);
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            bool dark = ((x / square) + (y / square)) % 2 != 0;
+            std::uint32_t r = dark ? 40 : 255;
+            std::uint32_t g = dark ? 40 : static_cast<std::uint32_t>(128 + x / 2);
+            std::uint32_t b = dark ? static_cast<std::uint32_t>(60 + y / 2) : 96;
+            rgba[y * size + x] = r | (g << 8) | (b << 16) | 0xFF000000u;
+        }
+    }
+    return texture.create(size, size, rgba.data());
+}
+
+// Lay the copies out on a square grid in the XZ plane, centered on the origin
+static std::vector<Mesh> buildScene(const Mesh& source, int copies, float& sceneRadius) {
+    std::vector<Mesh> meshes;
+    meshes.reserve(copies);
+
+    int gridSize = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(copies))));
+    const float spacing = 3.0f;
+    float offset = (gridSize - 1) * spacing * 0.5f;
+
+    for (int i = 0; i < copies; ++i) {
+        Mesh mesh = source;
+        int gx = i % gridSize;
+        int gz = i / gridSize;
+        mesh.setWorldPosition(gx * spacing - offset, 0.0f, gz * spacing - offset);
+        mesh.setWorldRotation(0.3f * i, 0.7f * i, 0.0f);
+        meshes.push_back(mesh);
+    }
+
+    sceneRadius = offset + spacing;
+    return meshes;
+}
+
+// Two walls built from a unit cube, crossing at the origin and reaching above the
+// camera path, marked as occluders so the grid quadrants behind them can be culled
+static bool addWalls(std::vector<Mesh>& meshes, float sceneRadius) {
+    Mesh wall;
+    if (!wall.loadFromOBJ("assets/cube.obj")) {
+        return false;
+    }
+    wall.setOccluder(true);
+
+    float halfHeight = sceneRadius * 0.25f + 2.5f;
+    wall.setWorldPosition(0.0f, halfHeight - 1.0f, 0.0f);
+    wall.setWorldScale(sceneRadius, halfHeight, 0.25f);
+    meshes.push_back(wall);
+    wall.setWorldScale(0.25f, halfHeight, sceneRadius);
+    meshes.push_back(wall);
+    return true;
+}
+
+// Scripted camera path: one full orbit around the scene over the measured frames
+static void updateCamera(Camera& camera, int frame, int frameCount, float sceneRadius) {
+    float t = static_cast<float>(frame) / static_cast<float>(frameCount);
+    float angle = t * 2.0f * 3.14159f;
+    float distance = sceneRadius * 1.5f + 4.0f;
+
+    camera.position = Vector3(std::sin(angle) * distance,
+                              sceneRadius * 0.5f + 2.0f,
+                              std::cos(angle) * distance);
+    camera.target = Vector3(0.0f, 0.0f, 0.0f);
+}
+
+// FNV-1a over the RGB bytes of a resolved frame, used to check that runs produce identical images
+static unsigned long long hashFrame(const std::vector<std::uint32_t>& pixels, unsigned long long hash) {
+    for (std::uint32_t pixel : pixels) {
+        const unsigned char rgb[3] = { static_cast<unsigned char>(pixel), static_cast<unsigned char>(pixel >> 8),
+                                       static_cast<unsigned char>(pixel >> 16) };
+        for (unsigned char byte : rgb) {
+            hash ^= byte;
+            hash *= 1099511628211ULL;
+        }
+    }
+    return hash;
+}
+
+static double percentile(std::vector<double> sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    std::sort(sorted.begin(), sorted.end());
+    double rank = p * (sorted.size() - 1);
+    size_t lower = static_cast<size_t>(rank);
+    size_t upper = std::min(lower + 1, sorted.size() - 1);
+    double fraction = rank - lower;
+    return sorted[lower] + (sorted[upper] - sorted[lower]) * fraction;
+}
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (options.walls && options.instanced) {
+        fprintf(stderr, "--walls cannot be combined with --instanced\n");
+        return 1;
+    }
+
+    Trace::setThreadName("Main");
+    Trace::setEnabled(!options.tracePath.empty());
+
+    Mesh source;
+    auto loadStart = std::chrono::steady_clock::now();
+    bool loaded = options.useCache ? MeshCache::load(options.meshPath, source)
+                                   : source.loadFromOBJ(options.meshPath);
+    double loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+    if (!loaded) {
+        fprintf(stderr, "Failed to load mesh: %s\n", options.meshPath.c_str());
+        return 1;
+    }
+    printf("Loaded %s in %.3f ms (%s)\n", options.meshPath.c_str(), loadMs,
+           source.hasExternalGeometry() ? "mapped cache" : "OBJ");
+
+    if (options.optimize) {
+        MeshOptimizeStats optimized = MeshOptimizer::optimize(source);
+        printf("Optimized: %zu -> %zu vertices, %zu -> %zu triangles, ACMR %.3f -> %.3f\n",
+               optimized.verticesBefore, optimized.verticesAfter, optimized.trianglesBefore,
+               optimized.trianglesAfter, optimized.acmrBefore, optimized.acmrAfter);
+    }
+
+    if (options.lod) {
+        auto lodStart = std::chrono::steady_clock::now();
+        MeshSimplifier::generateLODs(source);
+        double lodMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - lodStart).count();
+        printf("LODs:          %zu levels in %.1f ms:", source.getLODCount() - 1, lodMs);
+        for (size_t level = 0; level < source.getLODCount(); ++level) {
+            printf(" %zu", source.getLODTriangleCount(level));
+        }
+        printf(" triangles\n");
+    }
+
+    // Before the copies are made, so they share the texture
+    std::shared_ptr<Texture> texture;
+    if (!options.texturePath.empty()) {
+        texture = std::make_shared<Texture>();
+        bool textureLoaded = options.texturePath == "checker" ? makeCheckerTexture(*texture)
+                                                              : texture->loadFromPPM(options.texturePath);
+        if (!textureLoaded) {
+            fprintf(stderr, "Failed to load texture: %s\n", options.texturePath.c_str());
+            return 1;
+        }
+        if (!source.hasTexCoords()) {
+            fprintf(stderr, "Warning: %s has no texture coordinates, drawing untextured\n", options.meshPath.c_str());
+        }
+        source.setTexture(texture);
+        printf("Texture:       %dx%d, %d mip levels, %.1f KB\n", texture->getWidth(), texture->getHeight(),
+               texture->getLevelCount(), texture->getMemoryUsage() / 1024.0);
+    }
+
+    float sceneRadius = 0.0f;
+    std::vector<Mesh> meshes = buildScene(source, options.copies, sceneRadius);
+    if (options.walls && !addWalls(meshes, sceneRadius)) {
+        fprintf(stderr, "Failed to load mesh: assets/cube.obj\n");
+        return 1;
+    }
+    size_t trianglesPerFrame = 0;
+    for (const Mesh& mesh : meshes) {
+        trianglesPerFrame += mesh.getTriangleCount();
+    }
+
+    // Copies share the source geometry, so memory stays that of one mesh
+    std::unordered_set<const MeshData*> uniqueGeometry;
+    size_t geometryBytes = 0;
+    for (const Mesh& mesh : meshes) {
+        if (uniqueGeometry.insert(&mesh.getGeometry()).second) {
+            geometryBytes += mesh.getGeometry().getMemoryUsage();
+        }
+    }
+
+    std::vector<Matrix4> instanceTransforms;
+    for (const Mesh& mesh : meshes) {
+        instanceTransforms.push_back(mesh.getWorldTransformMatrix());
+    }
+
+    Scene scene;
+    if (options.useScene) {
+        scene.reserve(meshes.size());
+        for (const Mesh& mesh : meshes) {
+            scene.addMesh(mesh);
+        }
+    }
+
+    Renderer renderer(options.width, options.height);
+    renderer.setThreadCount(options.threads);
+    renderer.setOcclusionCulling(options.occlusion);
+
+    Camera camera;
+    camera.aspectRatio = static_cast<float>(options.width) / options.height;
+    camera.farPlane = 1000.0f;
+
+    // Same three-light rig as the interactive viewer
+    std::vector<Light> lights;
+    lights.push_back(Light(Vector3(0, 0, 0), Vector3(-0.7f, 0.8f, -1.0f).normalized(),
+                           Color(40, 40, 40), Color(200, 200, 180), Color(180, 180, 180)));
+    lights.push_back(Light(Vector3(0, 0, 0), Vector3(1.0f, 0.2f, -0.5f).normalized(),
+                           Color(20, 20, 20), Color(80, 80, 120), Color(100, 100, 100)));
+    lights.push_back(Light(Vector3(0, 0, 0), Vector3(0.2f, 0.5f, 1.0f).normalized(),
+                           Color(10, 10, 10), Color(60, 70, 80), Color(150, 150, 150)));
+    Material material(0.4f, 0.7f, 0.3f, 32.0f);
+
+    printf("Scene: %zu meshes, %zu triangles/frame, %dx%d, %s mode, %d threads%s\n",
+           meshes.size(), trianglesPerFrame, options.width, options.height,
+           options.lighting ? "light" : "mesh", renderer.getThreadCount(),
+           options.occlusion ? ", occlusion culling" : "");
+    printf("Geometry:      %zu unique, %.1f KB\n", uniqueGeometry.size(), geometryBytes / 1024.0);
+    if (options.useScene) {
+        printf("Rendering through Scene BVH\n");
+    } else if (options.instanced) {
+        printf("Rendering instanced\n");
+    }
+
+    std::vector<double> frameTimes;
+    frameTimes.reserve(options.frames);
+    unsigned long long checksum = 14695981039346656037ULL;
+    size_t frustumCulled = 0;
+    size_t occlusionCulled = 0;
+    size_t lodTrianglesSkipped = 0;
+    size_t litCorners = 0;
+    size_t litVertices = 0;
+    FrameStats statsTotal;      // Sums over the measured frames
+
+    std::ofstream statsFile;
+    if (!options.statsPath.empty()) {
+        statsFile.open(options.statsPath);
+        if (!statsFile.is_open()) {
+            fprintf(stderr, "Failed to write %s\n", options.statsPath.c_str());
+            return 1;
+        }
+        FrameStats::writeCSVHeader(statsFile);
+    }
+
+    // Clear, render and resolve one frame (on the pipeline's render thread with --pipeline)
+    auto renderFrame = [&](Renderer& target, const Camera& frameCamera, int frame) {
+        TRACE_SCOPE("Render frame");
+        target.clear(Color(20, 20, 40));
+        if (options.useScene) {
+            if (options.lighting) {
+                target.render_Light(scene, frameCamera, lights, material);
+            } else {
+                target.render_Mesh(scene, frameCamera);
+            }
+        } else if (options.instanced) {
+            if (options.lighting) {
+                target.render_LightInstanced(source.getGeometry(), instanceTransforms, frameCamera, lights, material,
+                                             texture.get());
+            } else {
+                target.render_MeshInstanced(source.getGeometry(), instanceTransforms, frameCamera);
+            }
+        } else if (options.lighting) {
+            target.render_Light(meshes, frameCamera, lights, material);
+        } else {
+            target.render_Mesh(meshes, frameCamera);
+        }
+
+        if (frame < 0) return; // Warmup frames are not counted
+        frustumCulled += target.getCullStats().frustumCulled;
+        occlusionCulled += target.getCullStats().occlusionCulled;
+        lodTrianglesSkipped += target.getCullStats().lodTrianglesSkipped;
+        litCorners += target.getLightingStats().corners;
+        litVertices += target.getLightingStats().litVertices;
+    };
+
+    // Stand-in for presenting to a window (texture upload, vsync)
+    auto simulatePresent = [&]() {
+        TRACE_SCOPE("Present");
+        if (options.presentMs > 0.0) {
+            std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(options.presentMs));
+        }
+    };
+
+    // Checksum, statistics and optional PPM of a measured frame
+    auto recordFrame = [&](const std::vector<std::uint32_t>& pixels, const FrameStats& stats, int frame) {
+        checksum = hashFrame(pixels, checksum);
+        statsTotal.trianglesSubmitted += stats.trianglesSubmitted;
+        statsTotal.trianglesBehindCamera += stats.trianglesBehindCamera;
+        statsTotal.trianglesOffScreen += stats.trianglesOffScreen;
+        statsTotal.trianglesBackFacing += stats.trianglesBackFacing;
+        statsTotal.trianglesDegenerate += stats.trianglesDegenerate;
+        statsTotal.pixelsTested += stats.pixelsTested;
+        statsTotal.pixelsPassed += stats.pixelsPassed;
+        statsTotal.screenPixels += stats.screenPixels;
+        statsTotal.clearMs += stats.clearMs;
+        statsTotal.transformMs += stats.transformMs;
+        statsTotal.lightingMs += stats.lightingMs;
+        statsTotal.rasterMs += stats.rasterMs;
+        statsTotal.presentMs += stats.presentMs;
+        if (statsFile.is_open()) {
+            stats.writeCSVRow(statsFile);
+        }
+        if (!options.ppmDir.empty() && frame % options.ppmEvery == 0) {
+            char filename[64];
+            std::snprintf(filename, sizeof(filename), "/frame_%04d.ppm", frame);
+            if (!renderer.saveToPPM(options.ppmDir + filename, pixels)) {
+                fprintf(stderr, "Failed to write %s%s\n", options.ppmDir.c_str(), filename);
+            }
+        }
+    };
+
+    if (options.pipelineBuffers == 0) {
+        for (int frame = -options.warmup; frame < options.frames; ++frame) {
+            updateCamera(camera, std::max(frame, 0), options.frames, sceneRadius);
+
+            auto start = std::chrono::steady_clock::now();
+            renderFrame(renderer, camera, frame);
+            renderer.resolve();
+            simulatePresent();
+            auto end = std::chrono::steady_clock::now();
+
+            if (frame < 0) continue; // Warmup frames are not measured
+
+            double ms = std::chrono::duration<double, std::milli>(end - start).count();
+            frameTimes.push_back(ms);
+            recordFrame(renderer.getPixels(), renderer.getFrameStats(), frame);
+            if (options.verbose) {
+                printf("frame %4d: %8.3f ms\n", frame, ms);
+            }
+        }
+    } else {
+        // Frames render on the pipeline thread while this thread "presents" the
+        // previous one. Frame time is the interval between presented frames; the
+        // checksum and PPM bookkeeping run here, overlapped with rendering.
+        FramePipeline pipeline(renderer, options.pipelineBuffers);
+        auto lastPresent = std::chrono::steady_clock::now();
+
+        auto presentFrame = [&](const FramePipeline::Frame* presented) {
+            if (!presented) return;
+            simulatePresent();
+            auto now = std::chrono::steady_clock::now();
+            double ms = std::chrono::duration<double, std::milli>(now - lastPresent).count();
+            lastPresent = now;
+
+            int frame = static_cast<int>(presented->number) - options.warmup;
+            if (frame < 0) return;
+            frameTimes.push_back(ms);
+            recordFrame(presented->pixels, presented->stats, frame);
+            if (options.verbose) {
+                printf("frame %4d: %8.3f ms\n", frame, ms);
+            }
+        };
+
+        for (int frame = -options.warmup; frame < options.frames; ++frame) {
+            updateCamera(camera, std::max(frame, 0), options.frames, sceneRadius);
+            presentFrame(pipeline.submit([&renderFrame, camera, frame](Renderer& target) {
+                renderFrame(target, camera, frame);
+            }));
+        }
+        while (const FramePipeline::Frame* presented = pipeline.finish()) {
+            presentFrame(presented);
+        }
+
+        FramePipeline::Stats stats = pipeline.getStats();
+        printf("Pipeline:      %zu buffers, %.3f ms render, %.3f ms latency, %.3f ms stalled per frame\n",
+               pipeline.getBufferCount(), stats.renderMs / stats.frames, stats.latencyMs / stats.frames,
+               stats.stallMs / stats.frames);
+    }
+
+    double totalMs = 0.0;
+    for (double ms : frameTimes) totalMs += ms;
+    double meanMs = totalMs / frameTimes.size();
+    double trianglesPerSecond = (trianglesPerFrame * frameTimes.size()) / (totalMs / 1000.0);
+
+    printf("\nFrames:        %zu\n", frameTimes.size());
+    printf("Mean:          %.3f ms (%.1f fps)\n", meanMs, 1000.0 / meanMs);
+    printf("Min / Max:     %.3f / %.3f ms\n",
+           *std::min_element(frameTimes.begin(), frameTimes.end()),
+           *std::max_element(frameTimes.begin(), frameTimes.end()));
+    printf("p50 / p99:     %.3f / %.3f ms\n", percentile(frameTimes, 0.50), percentile(frameTimes, 0.99));
+    printf("Triangles/sec: %.3e\n", trianglesPerSecond);
+    printf("Culled:        %.1f frustum, %.1f occlusion meshes/frame\n",
+           static_cast<double>(frustumCulled) / frameTimes.size(),
+           static_cast<double>(occlusionCulled) / frameTimes.size());
+    if (options.lighting) {
+        printf("Lighting:      %.0f evaluations for %.0f corners/frame\n",
+               static_cast<double>(litVertices) / frameTimes.size(),
+               static_cast<double>(litCorners) / frameTimes.size());
+    }
+    if (FrameStats::ENABLED) {
+        double frames = static_cast<double>(frameTimes.size());
+        printf("Triangles:     %.0f submitted, %.0f drawn, culled %.0f behind camera, %.0f off-screen, "
+               "%.0f back-face, %.0f degenerate per frame\n",
+               statsTotal.trianglesSubmitted / frames, statsTotal.getTrianglesDrawn() / frames,
+               statsTotal.trianglesBehindCamera / frames, statsTotal.trianglesOffScreen / frames,
+               statsTotal.trianglesBackFacing / frames, statsTotal.trianglesDegenerate / frames);
+        printf("Pixels:        %.0f tested, %.0f passed per frame, overdraw %.2f\n",
+               statsTotal.pixelsTested / frames, statsTotal.pixelsPassed / frames, statsTotal.getOverdraw());
+        printf("Stages:        clear %.3f, transform %.3f, lighting %.3f, raster %.3f, present %.3f ms\n",
+               statsTotal.clearMs / frames, statsTotal.transformMs / frames, statsTotal.lightingMs / frames,
+               statsTotal.rasterMs / frames, statsTotal.presentMs / frames);
+    }
+    if (options.lod) {
+        printf("LOD savings:   %.0f triangles/frame\n", static_cast<double>(lodTrianglesSkipped) / frameTimes.size());
+    }
+    printf("Checksum:      %016llx\n", checksum);
+
+    if (!options.tracePath.empty()) {
+        Trace::setEnabled(false);
+        if (!Trace::writeJSON(options.tracePath)) {
+            fprintf(stderr, "Failed to write %s\n", options.tracePath.c_str());
+            return 1;
+        }
+        printf("Trace:         %s\n", options.tracePath.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,583 @@
+// Headless microbenchmarks for the math, lighting, raster and loader kernels.
+//
+// Each benchmark is calibrated to run at least --min-ms per sample and is
+// sampled --samples times; the median time per operation is reported along
+// with the spread (median absolute deviation). Results can be written as JSON
+// and compared against an earlier run to catch regressions.
+//
+// Usage: ./bench_micro [--filter text] [--samples N] [--min-ms MS]
+//                      [--json path.json] [--baseline path.json] [--threshold PCT]
+//                      [--list]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+#include "Color.hpp"
+#include "FrameStats.hpp"
+#include "Light.hpp"
+#include "LightingEngine.hpp"
+#include "LinearColor.hpp"
+#include "Material.hpp"
+#include "Matrix4.hpp"
+#include "Mesh.hpp"
+#include "Renderer.hpp"
+#include "Texture.hpp"
+#include "Vector3.hpp"
+
+// Private rasterizer access (friend of Renderer). Calls run serially over the
+// whole screen, like the single-threaded raster path.
+struct RendererBenchAccess {
+    using PixelCounters = Renderer::PixelCounters;
+
+    static Renderer::ScreenRect screen(const Renderer& renderer) {
+        return Renderer::ScreenRect{ 0, 0, renderer.getWidth() - 1, renderer.getHeight() - 1 };
+    }
+    static void fillTriangle_Scanline(Renderer& renderer, const Vector3& v0, const Vector3& v1, const Vector3& v2,
+                                      const LinearColor& color, PixelCounters& counters) {
+        renderer.fillTriangle_Scanline(v0, v1, v2, color, screen(renderer), counters);
+    }
+    static void fillTriangle_Gouraud(Renderer& renderer, const Vector3& v0, const Vector3& v1, const Vector3& v2,
+                                     const LinearColor& c0, const LinearColor& c1, const LinearColor& c2,
+                                     PixelCounters& counters) {
+        renderer.fillTriangle_Gouraud(v0, v1, v2, c0, c1, c2, screen(renderer), counters);
+    }
+    static void fillTriangle_Textured(Renderer& renderer, const Vector3& v0, const Vector3& v1, const Vector3& v2,
+                                      const LinearColor& c0, const LinearColor& c1, const LinearColor& c2,
+                                      const Vector3& t0, const Vector3& t1, const Vector3& t2,
+                                      const Texture& texture, PixelCounters& counters) {
+        renderer.fillTriangle_Textured(v0, v1, v2, c0, c1, c2, t0, t1, t2, texture, screen(renderer), counters);
+    }
+    static void drawLine_Bresenham_Depth(Renderer& renderer, int x0, int y0, int x1, int y1, float z0, float z1,
+                                         const LinearColor& color, PixelCounters& counters) {
+        renderer.drawLine_Bresenham_Depth(x0, y0, x1, y1, z0, z1, color, screen(renderer), counters);
+    }
+    static void resetDepth(Renderer& renderer) {
+        std::fill(renderer.zBuffer.begin(), renderer.zBuffer.end(), std::numeric_limits<float>::max());
+    }
+};
+
+struct MicroOptions {
+    std::string filter;
+    int samples = 7;
+    double minMs = 25.0;
+    std::string jsonPath;
+    std::string baselinePath;
+    double threshold = 10.0;    // Percent slowdown reported as a regression
+    bool list = false;
+};
+
+struct BenchResult {
+    std::string name;
+    double nsPerOp = 0.0;       // Median over the samples
+    double minNsPerOp = 0.0;
+    double madPercent = 0.0;    // Median absolute deviation relative to the median
+    size_t iterations = 0;      // Per sample
+    double itemsPerOp = 0.0;    // Pixels, vertices, bytes... (0 when not meaningful)
+    std::string itemName;
+};
+
+// Keeps the compiler from discarding a computed value
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+static void printUsage(const char* program) {
+    printf("Usage: %s [--filter text] [--samples N] [--min-ms MS]\n"
+           "          [--json path.json] [--baseline path.json] [--threshold PCT]\n"
+           "          [--list]\n", program);
+}
+
+static bool parseOptions(int argc, char** argv, MicroOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--filter" && hasValue) {
+            options.filter = argv[++i];
+        } else if (arg == "--samples" && hasValue) {
+            options.samples = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--min-ms" && hasValue) {
+            options.minMs = std::max(0.1, std::atof(argv[++i]));
+        } else if (arg == "--json" && hasValue) {
+            options.jsonPath = argv[++i];
+        } else if (arg == "--baseline" && hasValue) {
+            options.baselinePath = argv[++i];
+        } else if (arg == "--threshold" && hasValue) {
+            options.threshold = std::max(0.0, std::atof(argv[++i]));
+        } else if (arg == "--list") {
+            options.list = true;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+static double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    size_t middle = values.size() / 2;
+    return values.size() % 2 ? values[middle] : (values[middle - 1] + values[middle]) * 0.5;
+}
+
+// Runs the registered benchmarks. A benchmark body performs the operation
+// `iterations` times; setup work belongs outside the body.
+class MicroBench {
+public:
+    explicit MicroBench(const MicroOptions& options) : options(options) {}
+
+    void run(const std::string& name, double itemsPerOp, const std::string& itemName,
+             const std::function<void(size_t)>& body) {
+        if (options.list) {
+            printf("%s\n", name.c_str());
+            return;
+        }
+        if (!options.filter.empty() && name.find(options.filter) == std::string::npos) return;
+
+        // Calibrate: grow the iteration count until a sample takes about minMs
+        body(1);
+        size_t iterations = 1;
+        while (true) {
+            double ms = time(body, iterations);
+            if (ms >= options.minMs) break;
+            double scale = ms > 0.0 ? options.minMs / ms * 1.2 : 10.0;
+            iterations = static_cast<size_t>(std::ceil(iterations * std::min(std::max(scale, 1.5), 10.0)));
+        }
+
+        std::vector<double> samples;
+        for (int s = 0; s < options.samples; ++s) {
+            samples.push_back(time(body, iterations) * 1e6 / iterations);
+        }
+
+        BenchResult result;
+        result.name = name;
+        result.nsPerOp = median(samples);
+        result.minNsPerOp = *std::min_element(samples.begin(), samples.end());
+        std::vector<double> deviations;
+        for (double sample : samples) deviations.push_back(std::fabs(sample - result.nsPerOp));
+        result.madPercent = result.nsPerOp > 0.0 ? median(deviations) / result.nsPerOp * 100.0 : 0.0;
+        result.iterations = iterations;
+        result.itemsPerOp = itemsPerOp;
+        result.itemName = itemName;
+        results.push_back(result);
+
+        printf("%-40s %14.1f ns/op  +-%5.1f%%", name.c_str(), result.nsPerOp, result.madPercent);
+        if (itemsPerOp > 0.0) {
+            printf("  %10.3e %s/s", itemsPerOp * 1e9 / result.nsPerOp, itemName.c_str());
+        }
+        printf("\n");
+        fflush(stdout);
+    }
+
+    const std::vector<BenchResult>& getResults() const { return results; }
+
+private:
+    static double time(const std::function<void(size_t)>& body, size_t iterations) {
+        auto start = std::chrono::steady_clock::now();
+        body(iterations);
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    const MicroOptions& options;
+    std::vector<BenchResult> results;
+};
+
+// One benchmark per line so the files diff cleanly and --baseline can read them back
+static bool writeJSON(const std::string& path, const std::vector<BenchResult>& results, const MicroOptions& options) {
+    std::ofstream file(path);
+    if (!file.is_open()) return false;
+
+#if defined(__AVX2__)
+    const char* isa = "avx2";
+#elif defined(__AVX__)
+    const char* isa = "avx";
+#elif defined(__SSE2__)
+    const char* isa = "sse2";
+#else
+    const char* isa = "scalar";
+#endif
+    char line[512];
+    std::snprintf(line, sizeof(line),
+                  "{\n\"context\": {\"compiler\": \"%s\", \"isa\": \"%s\", \"frame_stats\": %d, "
+                  "\"samples\": %d, \"min_ms\": %.1f},\n\"benchmarks\": [\n",
+                  __VERSION__, isa, FRAME_STATS, options.samples, options.minMs);
+    file << line;
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        std::snprintf(line, sizeof(line),
+                      "{\"name\": \"%s\", \"ns_per_op\": %.3f, \"min_ns_per_op\": %.3f, \"mad_percent\": %.2f, "
+                      "\"iterations\": %zu, \"items_per_op\": %.1f, \"items\": \"%s\"}%s\n",
+                      r.name.c_str(), r.nsPerOp, r.minNsPerOp, r.madPercent, r.iterations, r.itemsPerOp,
+                      r.itemName.c_str(), i + 1 < results.size() ? "," : "");
+        file << line;
+    }
+    file << "]\n}\n";
+    return file.good();
+}
+
+// Reads name -> min_ns_per_op back from a file written by writeJSON
+static bool readBaseline(const std::string& path, std::map<std::string, double>& baseline) {
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t nameStart = line.find("{\"name\": \"");
+        size_t timeStart = line.find("\"min_ns_per_op\": ");
+        if (nameStart == std::string::npos || timeStart == std::string::npos) continue;
+        nameStart += 10;
+        size_t nameEnd = line.find('"', nameStart);
+        baseline[line.substr(nameStart, nameEnd - nameStart)] = std::atof(line.c_str() + timeStart + 17);
+    }
+    return true;
+}
+
+// Closed grid mesh (a displaced sphere) with about `triangles` triangles, as OBJ text
+static bool writeSphereOBJ(const std::string& path, int triangles) {
+    std::ofstream file(path);
+    if (!file.is_open()) return false;
+
+    int rings = std::max(2, static_cast<int>(std::sqrt(triangles / 2.0)));
+    int segments = rings;
+    char line[128];
+    for (int ring = 0; ring <= rings; ++ring) {
+        float theta = 3.14159265f * ring / rings;
+        for (int segment = 0; segment < segments; ++segment) {
+            float phi = 2.0f * 3.14159265f * segment / segments;
+            float radius = 1.0f + 0.05f * std::sin(7.0f * phi) * std::sin(5.0f * theta);
+            std::snprintf(line, sizeof(line), "v %.6f %.6f %.6f\n", radius * std::sin(theta) * std::cos(phi),
+                          radius * std::cos(theta), radius * std::sin(theta) * std::sin(phi));
+            file << line;
+        }
+    }
+    for (int ring = 0; ring < rings; ++ring) {
+        for (int segment = 0; segment < segments; ++segment) {
+            int a = ring * segments + segment + 1;
+            int b = ring * segments + (segment + 1) % segments + 1;
+            int c = a + segments;
+            int d = b + segments;
+            std::snprintf(line, sizeof(line), "f %d %d %d\nf %d %d %d\n", a, c, b, b, c, d);
+            file << line;
+        }
+    }
+    return file.good();
+}
+
+int main(int argc, char** argv) {
+    MicroOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    MicroBench bench(options);
+
+    // Inputs are varied per element so nothing folds into a constant
+    const size_t COUNT = 1024;
+    std::vector<Vector3> vectors(COUNT), others(COUNT), results(COUNT);
+    std::vector<Matrix4> matrices(COUNT);
+    for (size_t i = 0; i < COUNT; ++i) {
+        float t = static_cast<float>(i);
+        vectors[i] = Vector3(std::sin(t) * 3.0f + 0.1f, std::cos(t * 0.7f) * 2.0f, std::sin(t * 1.3f) + 2.0f);
+        others[i] = Vector3(std::cos(t * 0.3f), std::sin(t * 0.9f) + 0.5f, std::cos(t * 1.7f) * 4.0f);
+        matrices[i] = Matrix4::translation(t * 0.01f, 1.0f, -2.0f) * Matrix4::rotationY(t * 0.1f) *
+                      Matrix4::scale(1.0f + t * 0.001f, 1.0f, 1.0f);
+    }
+
+    // Math
+    bench.run("Matrix4::operator*", 1, "matrices", [&](size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+            Matrix4 product = matrices[i % COUNT] * matrices[(i + 1) % COUNT];
+            doNotOptimize(product);
+        }
+    });
+    bench.run("Matrix4::multiply", COUNT, "points", [&](size_t iterations) {
+        const Matrix4& matrix = matrices[7];
+        for (size_t i = 0; i < iterations; ++i) {
+            for (size_t k = 0; k < COUNT; ++k) results[k] = matrix.multiply(vectors[k]);
+            doNotOptimize(results[i % COUNT]);
+        }
+    });
+    bench.run("Vector3::normalized", COUNT, "vectors", [&](size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+            for (size_t k = 0; k < COUNT; ++k) results[k] = vectors[k].normalized();
+            doNotOptimize(results[i % COUNT]);
+        }
+    });
+    bench.run("Vector3::cross", COUNT, "vectors", [&](size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+            for (size_t k = 0; k < COUNT; ++k) results[k] = vectors[k].cross(others[k]);
+            doNotOptimize(results[i % COUNT]);
+        }
+    });
+
+    // Lighting: the viewer's three-light rig
+    std::vector<Light> lights;
+    lights.push_back(Light(Vector3(0, 0, 0), Vector3(-0.7f, 0.8f, -1.0f).normalized(),
+                           Color(40, 40, 40), Color(200, 200, 180), Color(180, 180, 180)));
+    lights.push_back(Light(Vector3(0, 0, 0), Vector3(1.0f, 0.2f, -0.5f).normalized(),
+                           Color(20, 20, 20), Color(80, 80, 120), Color(100, 100, 100)));
+    lights.push_back(Light(Vector3(0, 0, 0), Vector3(0.2f, 0.5f, 1.0f).normalized(),
+                           Color(10, 10, 10), Color(60, 70, 80), Color(150, 150, 150)));
+    Material material(0.4f, 0.7f, 0.3f, 32.0f);
+    std::vector<Vector3> normals(COUNT), viewDirs(COUNT);
+    for (size_t i = 0; i < COUNT; ++i) {
+        normals[i] = vectors[i].normalized();
+        viewDirs[i] = (Vector3(0.0f, 0.0f, 5.0f) - vectors[i]).normalized();
+    }
+    std::vector<Color> colors(COUNT);
+    bench.run("Light::computeColor", COUNT, "vertices", [&](size_t iterations) {
+        const Light& light = lights[0];
+        for (size_t i = 0; i < iterations; ++i) {
+            for (size_t k = 0; k < COUNT; ++k) colors[k] = light.computeColor(normals[k], viewDirs[k], material);
+            doNotOptimize(colors[i % COUNT]);
+        }
+    });
+
+    LightingEngine lightingEngine;
+    lightingEngine.prepare(lights, material, Vector3(0.0f, 0.0f, 5.0f));
+    AlignedFloatVector px(COUNT), py(COUNT), pz(COUNT), nx(COUNT), ny(COUNT), nz(COUNT);
+    for (size_t i = 0; i < COUNT; ++i) {
+        px[i] = vectors[i].x; py[i] = vectors[i].y; pz[i] = vectors[i].z;
+        nx[i] = normals[i].x; ny[i] = normals[i].y; nz[i] = normals[i].z;
+    }
+    std::vector<LinearColor> litColors(COUNT);
+    bench.run("LightingEngine::evaluate (3 lights)", COUNT, "vertices", [&](size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+            lightingEngine.evaluate(px.data(), py.data(), pz.data(), nx.data(), ny.data(), nz.data(),
+                                    COUNT, litColors.data());
+            doNotOptimize(litColors[i % COUNT]);
+        }
+    });
+
+    // Rasterization on an 800x600 target. Each call draws nearer than the last
+    // so the depth test passes; the depth buffer is reset every DEPTH_STEPS calls.
+    Renderer renderer(800, 600);
+    renderer.setThreadCount(1);
+    const int width = renderer.getWidth();
+    const int height = renderer.getHeight();
+    const size_t DEPTH_STEPS = 1024;
+    auto depthFor = [&](size_t i) {
+        size_t step = i % DEPTH_STEPS;
+        if (step == 0) RendererBenchAccess::resetDepth(renderer);
+        return 0.9f - 1.8f * static_cast<float>(step) / DEPTH_STEPS;
+    };
+    auto coveredPixels = [&](const std::function<void(RendererBenchAccess::PixelCounters&)>& draw) {
+        RendererBenchAccess::resetDepth(renderer);
+        RendererBenchAccess::PixelCounters counters;
+        draw(counters);
+        return static_cast<double>(counters.tested);
+    };
+
+    struct TriangleCase {
+        const char* name;
+        float x0, y0, x1, y1, x2, y2;
+    };
+    const float w = static_cast<float>(width), h = static_cast<float>(height);
+    const TriangleCase triangles[] = {
+        { "tiny", 400.2f, 300.3f, 403.7f, 300.6f, 401.1f, 303.9f },
+        { "medium", 300.5f, 200.5f, 460.5f, 230.5f, 340.5f, 390.5f },
+        { "screen", 0.0f, 0.0f, 2.0f * w, 0.0f, 0.0f, 2.0f * h },
+    };
+    const LinearColor red(1.0f, 0.3f, 0.3f), green(0.3f, 1.0f, 0.3f), blue(0.3f, 0.3f, 1.0f);
+
+    // 512x512 noise texture, mapped 4 times across each triangle with a perspective
+    // tilt (1/w from 1 down to 0.25), so several mip levels are sampled
+    Texture texture;
+    {
+        const int TEXTURE_SIZE = 512;
+        std::vector<std::uint32_t> texels(TEXTURE_SIZE * TEXTURE_SIZE);
+        std::uint32_t seed = 12345;
+        for (std::uint32_t& texel : texels) {
+            seed = seed * 1664525u + 1013904223u;
+            texel = (seed >> 8) | 0xFF000000u;
+        }
+        texture.create(TEXTURE_SIZE, TEXTURE_SIZE, texels.data());
+    }
+    const Vector3 texCoords[3] = { Vector3(0.0f, 0.0f, 1.0f), Vector3(4.0f * 0.25f, 0.0f, 0.25f),
+                                   Vector3(0.0f, 4.0f * 0.5f, 0.5f) };
+    // Level 0 along an oblique line, about one texel per step
+    bench.run("Texture::sample", COUNT, "samples", [&](size_t iterations) {
+        LinearColor sum;
+        for (size_t i = 0; i < iterations; ++i) {
+            float start = static_cast<float>(i % 64) * 0.01f;
+            for (size_t k = 0; k < COUNT; ++k) {
+                sum = sum + texture.sample(0, start + k * 0.0005f, start + k * 0.0018f);
+            }
+        }
+        doNotOptimize(sum);
+    });
+
+    for (const TriangleCase& t : triangles) {
+        auto vertices = [&t](float z, Vector3* v) {
+            v[0] = Vector3(t.x0, t.y0, z);
+            v[1] = Vector3(t.x1, t.y1, z);
+            v[2] = Vector3(t.x2, t.y2, z);
+        };
+        RendererBenchAccess::PixelCounters counters;
+
+        double pixels = coveredPixels([&](RendererBenchAccess::PixelCounters& c) {
+            Vector3 v[3];
+            vertices(0.0f, v);
+            RendererBenchAccess::fillTriangle_Scanline(renderer, v[0], v[1], v[2], red, c);
+        });
+        bench.run(std::string("fillTriangle_Scanline/") + t.name, pixels, "pixels", [&](size_t iterations) {
+            Vector3 v[3];
+            for (size_t i = 0; i < iterations; ++i) {
+                vertices(depthFor(i), v);
+                RendererBenchAccess::fillTriangle_Scanline(renderer, v[0], v[1], v[2], red, counters);
+            }
+        });
+
+        pixels = coveredPixels([&](RendererBenchAccess::PixelCounters& c) {
+            Vector3 v[3];
+            vertices(0.0f, v);
+            RendererBenchAccess::fillTriangle_Gouraud(renderer, v[0], v[1], v[2], red, green, blue, c);
+        });
+        bench.run(std::string("fillTriangle_Gouraud/") + t.name, pixels, "pixels", [&](size_t iterations) {
+            Vector3 v[3];
+            for (size_t i = 0; i < iterations; ++i) {
+                vertices(depthFor(i), v);
+                RendererBenchAccess::fillTriangle_Gouraud(renderer, v[0], v[1], v[2], red, green, blue, counters);
+            }
+        });
+
+        pixels = coveredPixels([&](RendererBenchAccess::PixelCounters& c) {
+            Vector3 v[3];
+            vertices(0.0f, v);
+            RendererBenchAccess::fillTriangle_Textured(renderer, v[0], v[1], v[2], red, green, blue,
+                                                       texCoords[0], texCoords[1], texCoords[2], texture, c);
+        });
+        bench.run(std::string("fillTriangle_Textured/") + t.name, pixels, "pixels", [&](size_t iterations) {
+            Vector3 v[3];
+            for (size_t i = 0; i < iterations; ++i) {
+                vertices(depthFor(i), v);
+                RendererBenchAccess::fillTriangle_Textured(renderer, v[0], v[1], v[2], red, green, blue,
+                                                           texCoords[0], texCoords[1], texCoords[2], texture,
+                                                           counters);
+            }
+        });
+        doNotOptimize(counters.passed);
+    }
+
+    struct LineCase {
+        const char* name;
+        int x0, y0, x1, y1;
+    };
+    const LineCase lines[] = {
+        { "short", 390, 295, 406, 303 },
+        { "diagonal", 0, 0, width - 1, height - 1 },
+    };
+    for (const LineCase& l : lines) {
+        RendererBenchAccess::PixelCounters counters;
+        double pixels = coveredPixels([&](RendererBenchAccess::PixelCounters& c) {
+            RendererBenchAccess::drawLine_Bresenham_Depth(renderer, l.x0, l.y0, l.x1, l.y1, 0.0f, 0.0f, red, c);
+        });
+        bench.run(std::string("drawLine_Bresenham_Depth/") + l.name, pixels, "pixels", [&](size_t iterations) {
+            for (size_t i = 0; i < iterations; ++i) {
+                float z = depthFor(i);
+                RendererBenchAccess::drawLine_Bresenham_Depth(renderer, l.x0, l.y0, l.x1, l.y1, z, z, red, counters);
+            }
+        });
+        doNotOptimize(counters.passed);
+    }
+
+    // Frame buffer clear and the resolve that feeds present() (the window
+    // upload itself needs SFML and is not measured here)
+    double screenPixels = static_cast<double>(width) * height;
+    bench.run("Renderer::clear", screenPixels, "pixels", [&](size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+            renderer.clear(Color(20, 20, 40));
+        }
+    });
+    bench.run("Renderer::resolve", screenPixels, "pixels", [&](size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+            renderer.resolve();
+            doNotOptimize(renderer.getPixels()[i % renderer.getPixels().size()]);
+        }
+    });
+    renderer.setToneMapping(AccumulationBuffer::ToneMapping::Reinhard);
+    bench.run("Renderer::resolve (Reinhard)", screenPixels, "pixels", [&](size_t iterations) {
+        for (size_t i = 0; i < iterations; ++i) {
+            renderer.resolve();
+            doNotOptimize(renderer.getPixels()[i % renderer.getPixels().size()]);
+        }
+    });
+
+    // OBJ loading from generated files of increasing size
+    if (!options.list) {
+        std::error_code error;
+        std::filesystem::path directory = std::filesystem::temp_directory_path(error);
+        if (error) directory = ".";
+        for (int triangleCount : { 1000, 32000, 512000 }) {
+            std::string name = "Mesh::loadFromOBJ/" + std::to_string(triangleCount / 1000) + "k";
+            if (!options.filter.empty() && name.find(options.filter) == std::string::npos) continue;
+
+            std::string path = (directory / ("bench_micro_" + std::to_string(triangleCount) + ".obj")).string();
+            if (!writeSphereOBJ(path, triangleCount)) {
+                fprintf(stderr, "Failed to write %s\n", path.c_str());
+                return 1;
+            }
+            double bytes = static_cast<double>(std::filesystem::file_size(path, error));
+            bench.run(name, bytes, "bytes", [&](size_t iterations) {
+                for (size_t i = 0; i < iterations; ++i) {
+                    Mesh mesh;
+                    if (!mesh.loadFromOBJ(path)) {
+                        fprintf(stderr, "Failed to load %s\n", path.c_str());
+                        std::exit(1);
+                    }
+                    doNotOptimize(mesh.getTriangleCount());
+                }
+            });
+            std::filesystem::remove(path, error);
+        }
+    } else {
+        for (const char* size : { "1k", "32k", "512k" }) printf("Mesh::loadFromOBJ/%s\n", size);
+    }
+    if (options.list) return 0;
+
+    const std::vector<BenchResult>& all = bench.getResults();
+    if (!options.jsonPath.empty()) {
+        if (!writeJSON(options.jsonPath, all, options)) {
+            fprintf(stderr, "Failed to write %s\n", options.jsonPath.c_str());
+            return 1;
+        }
+        printf("\nResults written to %s\n", options.jsonPath.c_str());
+    }
+
+    // Regression check against an earlier --json run. Compares the fastest
+    // samples, which are less disturbed by other load than the medians.
+    if (!options.baselinePath.empty()) {
+        std::map<std::string, double> baseline;
+        if (!readBaseline(options.baselinePath, baseline)) {
+            fprintf(stderr, "Failed to read %s\n", options.baselinePath.c_str());
+            return 1;
+        }
+        size_t regressions = 0;
+        printf("\nCompared with %s:\n", options.baselinePath.c_str());
+        for (const BenchResult& result : all) {
+            auto found = baseline.find(result.name);
+            if (found == baseline.end() || found->second <= 0.0) {
+                printf("%-40s %14s\n", result.name.c_str(), "new");
+                continue;
+            }
+            double change = (result.minNsPerOp / found->second - 1.0) * 100.0;
+            bool regressed = change > options.threshold;
+            regressions += regressed;
+            printf("%-40s %+13.1f%%%s\n", result.name.c_str(), change, regressed ? "  REGRESSION" : "");
+        }
+        if (regressions > 0) {
+            printf("%zu benchmark(s) slower than the baseline by more than %.1f%%\n", regressions, options.threshold);
+            return 2;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "AlignedAllocator.hpp"
+#include "LinearColor.hpp"
+
+// Float color buffer the rasterizers write into: one plane per channel in
+// linear light (see LinearColor), without clamping. resolve() clamps,
+// optionally tone maps, encodes to sRGB and packs the result into 32-bit
+// RGBA pixels.
+class AccumulationBuffer {
+public:
+    enum class ToneMapping {
+        Clamp,      // Values above 1 saturate
+        Reinhard    // Extended Reinhard per channel: whitePoint maps to 1
+    };
+
+    AccumulationBuffer(int width, int height);
+
+    void clear(const LinearColor& color);
+
+    // Channel planes, width * height floats each (rows top to bottom)
+    float* getRed() { return red.data(); }
+    float* getGreen() { return green.data(); }
+    float* getBlue() { return blue.data(); }
+    const float* getRed() const { return red.data(); }
+    const float* getGreen() const { return green.data(); }
+    const float* getBlue() const { return blue.data(); }
+
+    void setToneMapping(ToneMapping mode, float whitePoint = 2.0f);
+    ToneMapping getToneMapping() const { return toneMapping; }
+
+    // Resolve `count` pixels starting at pixel index `first` into out[first...].
+    // Each pixel holds the bytes R, G, B, A (alpha 255) in memory order on
+    // little-endian machines. Disjoint ranges can be resolved in parallel.
+    void resolve(std::uint32_t* out, size_t first, size_t count) const;
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    size_t getPixelCount() const { return static_cast<size_t>(width) * height; }
+
+private:
+    int width;
+    int height;
+    AlignedFloatVector red, green, blue;
+
+    ToneMapping toneMapping;
+    float invWhitePointSquared;
+};
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+// Minimal allocator returning memory aligned to Alignment bytes, so std::vector
+// storage can be used directly with aligned SIMD loads and stores.
+template <typename T, size_t Alignment = 32>
+class AlignedAllocator {
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(size_t count) {
+        // aligned_alloc requires the size to be a multiple of the alignment
+        size_t bytes = (count * sizeof(T) + Alignment - 1) / Alignment * Alignment;
+        void* memory = std::aligned_alloc(Alignment, bytes);
+        if (!memory) throw std::bad_alloc();
+        return static_cast<T*>(memory);
+    }
+
+    void deallocate(T* pointer, size_t) {
+        std::free(pointer);
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+// 32-byte aligned float array (one AVX register per 8 elements)
+using AlignedFloatVector = std::vector<float, AlignedAllocator<float, 32>>;
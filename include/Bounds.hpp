@@ -0,0 +1,43 @@
+#pragma once
+#include "Vector3.hpp"
+#include "Matrix4.hpp"
+
+// Axis-aligned bounding box. A default-constructed box is empty (min > max)
+// and becomes valid once the first point is added.
+class AABB {
+public:
+    Vector3 min;
+    Vector3 max;
+
+    AABB();
+    AABB(const Vector3& min, const Vector3& max);
+
+    bool isEmpty() const { return min.x > max.x; }
+
+    void expand(const Vector3& point);
+    void expand(const AABB& other);
+
+    Vector3 getCenter() const;
+    Vector3 getExtents() const;     // Half of the size along each axis
+
+    // Box enclosing this one after an affine transform
+    AABB transformed(const Matrix4& matrix) const;
+};
+
+// Bounding sphere. A negative radius marks an empty sphere.
+class BoundingSphere {
+public:
+    Vector3 center;
+    float radius;
+
+    BoundingSphere();
+    BoundingSphere(const Vector3& center, float radius);
+
+    bool isEmpty() const { return radius < 0.0f; }
+
+    // Grow just enough to enclose the point (Ritter's update step)
+    void expand(const Vector3& point);
+
+    // Sphere enclosing this one after an affine transform (radius scaled by the largest axis scale)
+    BoundingSphere transformed(const Matrix4& matrix) const;
+};
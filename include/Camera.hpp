@@ -1,6 +1,7 @@
 #pragma once
 #include "Vector3.hpp"
 #include "Matrix4.hpp"
+#include "Frustum.hpp"
 
 class Camera {
 public:
@@ -27,6 +28,9 @@ public:
     // Combined view-projection matrix
     Matrix4 getViewProjectionMatrix() const;
     
+    // World-space frustum planes of the view-projection matrix
+    Frustum getFrustum() const;
+    
     // Utility methods for projection settings
     void setPerspective(float fov, float aspect, float near, float far);
     void setAspectRatio(float aspect);
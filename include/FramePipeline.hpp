@@ -0,0 +1,94 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Renderer.hpp"
+#include "FrameStats.hpp"
+
+// Renders frames on a dedicated thread while the caller presents earlier ones.
+//
+// Each submitted frame is a function that draws into the renderer; the render
+// thread runs it, resolves the result into one of bufferCount frame buffers
+// and hands it back in submission order. Only the resolved pixels are
+// multi-buffered: the accumulation and depth buffers are used by one frame at
+// a time on the render thread.
+//
+// Up to bufferCount - 1 frames are rendered ahead of the one being presented
+// (2 = double buffering, 3 = triple), which also bounds the added input
+// latency to that many frames. While a frame is in flight the renderer and
+// everything its frame functions read belong to the render thread; calling
+// Renderer::present() with a returned frame from the submitting thread is safe.
+class FramePipeline {
+public:
+    // Draws one frame (clear and render passes; the pipeline resolves it)
+    using FrameFunction = std::function<void(Renderer&)>;
+
+    struct Frame {
+        std::vector<std::uint32_t> pixels;  // Resolved RGBA8, see Renderer::getPixels()
+        unsigned long long number = 0;      // Submission order, from 0
+        FrameStats stats;                   // Renderer::getFrameStats() after the resolve
+    };
+
+    // Totals over released frames (divide by frames for means)
+    struct Stats {
+        size_t frames = 0;
+        double renderMs = 0.0;      // Render thread time per frame (frame function and resolve)
+        double latencyMs = 0.0;     // Submission to release (the next submit() or finish())
+        double stallMs = 0.0;       // Time submit() and finish() spent waiting for the render thread
+    };
+
+    explicit FramePipeline(Renderer& renderer, size_t bufferCount = 2);
+    ~FramePipeline();   // Discards frames that have not started rendering
+
+    FramePipeline(const FramePipeline&) = delete;
+    FramePipeline& operator=(const FramePipeline&) = delete;
+
+    // Queue a frame, then return the oldest frame not yet returned once it is
+    // rendered and bufferCount - 1 newer frames are queued behind it (nullptr
+    // while the pipeline fills). A returned frame stays valid until the next
+    // submit() or finish(), which release its buffer.
+    const Frame* submit(FrameFunction frame);
+
+    // Wait for and return the oldest frame still in flight, or nullptr when
+    // every submitted frame has been returned. Used to drain the pipeline.
+    const Frame* finish();
+
+    size_t getBufferCount() const { return slots.size(); }
+    Stats getStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    enum class SlotState { Free, Queued, Rendered, Acquired };
+
+    struct Slot {
+        Frame frame;
+        SlotState state = SlotState::Free;
+        FrameFunction function;
+        Clock::time_point submitTime;
+        double renderMs = 0.0;
+    };
+
+    void renderLoop();
+    void releaseReturnedFrame();    // Callers hold the mutex
+    const Frame* waitForOldest(std::unique_lock<std::mutex>& lock);
+
+    Renderer& renderer;
+    std::vector<Slot> slots;
+    std::deque<size_t> renderQueue;     // Queued slots, oldest first
+    std::deque<size_t> presentQueue;    // Slots not yet released, oldest first
+    unsigned long long nextFrameNumber;
+    Stats stats;
+
+    mutable std::mutex mutex;
+    std::condition_variable frameQueued;
+    std::condition_variable frameRendered;
+    bool stopping;
+    std::thread renderThread;
+};
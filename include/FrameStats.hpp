@@ -0,0 +1,97 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+
+// Frame statistics are compiled in unless built with -DFRAME_STATS=0
+// (make FRAME_STATS=0). When disabled, counters and timers stay at zero and
+// cost nothing.
+#ifndef FRAME_STATS
+#define FRAME_STATS 1
+#endif
+
+#if FRAME_STATS
+#define FRAME_STATS_ADD(counter, amount) ((counter) += (amount))
+#else
+#define FRAME_STATS_ADD(counter, amount) ((void)sizeof((counter) += (amount)))   // Not evaluated
+#endif
+
+// Counters and stage timings for one frame, from Renderer::clear() to the
+// resolve (and present, when presenting from the renderer's own pixels).
+// Triangles are counted once each after mesh culling (see Renderer::CullStats
+// for whole meshes): every submitted triangle is either drawn or culled for
+// exactly one reason.
+struct FrameStats {
+    static const bool ENABLED = FRAME_STATS != 0;
+
+    unsigned long long frame = 0;           // Counts clear() calls, so the first frame is 1
+
+    // Triangle setup
+    size_t trianglesSubmitted = 0;          // Triangles of the drawn meshes (at their level of detail)
+    size_t trianglesBehindCamera = 0;       // All vertices nearer than the near plane (or behind the camera)
+    size_t trianglesOffScreen = 0;          // Outside another view volume plane or the screen
+    size_t trianglesBackFacing = 0;
+    size_t trianglesDegenerate = 0;         // Zero screen-space area
+
+    // Rasterization (depth-tested lines included)
+    size_t pixelsTested = 0;                // Covered pixels that reached the depth test
+    size_t pixelsPassed = 0;                // Pixels written
+    size_t screenPixels = 0;
+
+    size_t lightingEvaluations = 0;         // Vertices lit (see Renderer::LightingStats)
+
+    // Stage times in milliseconds
+    double clearMs = 0.0;
+    double transformMs = 0.0;   // Vertex processing, mesh and triangle culling, clipping and setup
+    double lightingMs = 0.0;    // Lighting kernel, including gathering its inputs
+    double rasterMs = 0.0;      // Binning and rasterization
+    double presentMs = 0.0;     // Resolve to RGBA8, plus Renderer::present(window)
+
+    size_t getTrianglesCulled() const {
+        return trianglesBehindCamera + trianglesOffScreen + trianglesBackFacing + trianglesDegenerate;
+    }
+    size_t getTrianglesDrawn() const { return trianglesSubmitted - getTrianglesCulled(); }
+
+    // Pixels written per screen pixel (1 = every pixel written once)
+    double getOverdraw() const { return screenPixels ? static_cast<double>(pixelsPassed) / screenPixels : 0.0; }
+
+    double getTotalMs() const { return clearMs + transformMs + lightingMs + rasterMs + presentMs; }
+
+    // One CSV line per frame: write the header once, then a row per frame
+    static void writeCSVHeader(std::ostream& out);
+    void writeCSVRow(std::ostream& out) const;
+};
+
+// Adds the time from construction (or the last switchTo) to a FrameStats
+// stage timer when destroyed. Does nothing when frame statistics are disabled.
+class StageTimer {
+public:
+#if FRAME_STATS
+    explicit StageTimer(double& stageMs) : stageMs(&stageMs), start(Clock::now()) {}
+    ~StageTimer() { stop(); }
+
+    // Charge the time so far to the current stage and start timing another
+    void switchTo(double& nextStageMs) {
+        Clock::time_point now = Clock::now();
+        *stageMs += std::chrono::duration<double, std::milli>(now - start).count();
+        stageMs = &nextStageMs;
+        start = now;
+    }
+#else
+    explicit StageTimer(double&) {}
+    void switchTo(double&) {}
+#endif
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+private:
+#if FRAME_STATS
+    using Clock = std::chrono::steady_clock;
+
+    void stop() { *stageMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count(); }
+
+    double* stageMs;
+    Clock::time_point start;
+#endif
+};
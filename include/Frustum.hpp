@@ -0,0 +1,37 @@
+#pragma once
+#include "Vector3.hpp"
+#include "Matrix4.hpp"
+#include "Bounds.hpp"
+
+// Plane in the form normal . p + distance = 0; the positive side faces inwards
+class Plane {
+public:
+    Vector3 normal;
+    float distance;
+
+    Plane();
+    Plane(const Vector3& normal, float distance);
+
+    // Signed distance (exact once normalized)
+    float distanceTo(const Vector3& point) const { return normal.dot(point) + distance; }
+    void normalize();
+};
+
+// View frustum as six inward-facing planes
+class Frustum {
+public:
+    enum PlaneIndex { PLANE_LEFT, PLANE_RIGHT, PLANE_BOTTOM, PLANE_TOP, PLANE_NEAR, PLANE_FAR, PLANE_COUNT };
+    enum TestResult { OUTSIDE, INTERSECTS, INSIDE };
+
+    Plane planes[PLANE_COUNT];
+
+    Frustum();
+
+    // Extract the planes from a (view-)projection matrix (Gribb-Hartmann).
+    // The planes live in the space the matrix transforms from: world space
+    // for a view-projection matrix, object space for a full MVP.
+    explicit Frustum(const Matrix4& viewProjection);
+
+    TestResult testSphere(const BoundingSphere& sphere) const;
+    TestResult testAABB(const AABB& box) const;
+};
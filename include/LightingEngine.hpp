@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "Vector3.hpp"
+#include "LinearColor.hpp"
+#include "Light.hpp"
+#include "Material.hpp"
+
+// Batched Gouraud lighting: the Phong model of Light::computeColor evaluated
+// over arrays of vertices in float (8 at a time with AVX, 4 with SSE2).
+//
+// prepare() does the per-pass work once: light directions are normalized, light
+// colors are premultiplied by the material coefficients and the ambient terms
+// are summed. The specular power comes from a table built per shininess.
+// Unlike Light::computeColor, results are linear float colors and are not
+// clamped (the accumulation buffer resolve does that).
+class LightingEngine {
+public:
+    // Specular table entries over [0, 1] (linearly interpolated)
+    static const size_t SPECULAR_TABLE_SIZE = 1024;
+
+    LightingEngine();
+
+    // Directional lights (Light::direction points towards the light)
+    void prepare(const std::vector<Light>& lights, const Material& material, const Vector3& viewPos);
+
+    // Light `count` vertices from SoA world positions and unit-length world normals
+    void evaluate(const float* px, const float* py, const float* pz,
+                  const float* nx, const float* ny, const float* nz,
+                  size_t count, LinearColor* out) const;
+
+    // Single vertex, same result as evaluate()
+    LinearColor evaluate(const Vector3& position, const Vector3& normal) const;
+
+    size_t getLightCount() const { return preparedLights.size(); }
+
+private:
+    struct PreparedLight {
+        float dirX, dirY, dirZ;     // Unit vector towards the light
+        float diffuseR, diffuseG, diffuseB;     // Light diffuse * kDiffuse (linear)
+        float specularR, specularG, specularB;  // Light specular * kSpecular (linear)
+    };
+
+    float specularPower(float x) const;
+    void buildSpecularTable(float exponent);
+
+    std::vector<PreparedLight> preparedLights;
+    float ambientR, ambientG, ambientB;     // Sum of light ambient * kAmbient (linear)
+    Vector3 viewPos;
+
+    // pow(i / SPECULAR_TABLE_SIZE, shininess), one extra entry for interpolation
+    std::vector<float> specularTable;
+    float tableShininess;
+};
@@ -0,0 +1,27 @@
+#pragma once
+#include "Color.hpp"
+
+// Float RGB in linear light, 1.0 = full 8-bit intensity. Colors, like images
+// and the display, are sRGB encoded: converting one decodes it, and the
+// accumulation buffer encodes the result again when it resolves a frame.
+// Values are not clamped: the buffer resolves them to 8 bits once per frame.
+class LinearColor {
+public:
+    float r, g, b;
+
+    LinearColor(float red = 0.0f, float green = 0.0f, float blue = 0.0f);
+    explicit LinearColor(const Color& color);
+
+    LinearColor operator+(const LinearColor& other) const;
+    LinearColor operator*(float factor) const;
+
+    // sRGB transfer function through lookup tables. The decode table maps each
+    // 8-bit code to linear [0, 1]; the encode table maps linear values in
+    // [0, 1], quantized to SRGB_ENCODE_TABLE_SIZE - 1 steps, back to the
+    // nearest code (fine enough that every code survives a round trip).
+    static constexpr int SRGB_ENCODE_TABLE_SIZE = 1 << 14;
+    static const float* getSRGBDecodeTable();
+    static const unsigned char* getSRGBEncodeTable();
+    static float decodeSRGB(unsigned char value) { return getSRGBDecodeTable()[value]; }
+    static unsigned char encodeSRGB(float value);   // Clamps to [0, 1]
+};
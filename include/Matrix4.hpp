@@ -1,5 +1,7 @@
 #pragma once
+#include <cstddef>
 #include "Vector3.hpp"
+#include "Vector4.hpp"
 
 class Matrix4 {
 public:
@@ -16,5 +18,19 @@ public:
     static Matrix4 projection(float fov, float aspect, float near, float far);
 
     Vector3 multiply(const Vector3& v) const;
+    
+    // Full homogeneous transform of (x, y, z, 1) without perspective divide
+    Vector4 multiplyHomogeneous(const Vector3& v) const;
+    
+    // Batched multiply() over structure-of-arrays positions, including the same
+    // perspective divide. Runs 8 points per iteration with AVX (4 with SSE2);
+    // inputs padded to a multiple of 8 never reach the scalar tail.
+    void transformPoints(const float* inX, const float* inY, const float* inZ,
+                         float* outX, float* outY, float* outZ, size_t count) const;
+    
+    // Batched multiplyHomogeneous(): writes clip-space x, y, z and w
+    void transformPointsHomogeneous(const float* inX, const float* inY, const float* inZ,
+                                    float* outX, float* outY, float* outZ, float* outW,
+                                    size_t count) const;
     Matrix4 operator*(const Matrix4& other) const;
 };
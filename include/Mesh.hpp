@@ -1,59 +1,95 @@
 #pragma once
 #include <vector>
+#include <memory>
 #include "Triangle.hpp"
 #include "Vertex.hpp"
 #include "Matrix4.hpp"
 #include "Vector3.hpp"
+#include "Bounds.hpp"
+#include "MeshData.hpp"
+#include "Transform.hpp"
 #include <string>
 
-class Mesh {
-public:
-    // Vertex buffer: stores unique vertices in LOCAL/OBJECT space
-    std::vector<Vertex> vertices;
-    
-    // Index buffer: stores indices that form triangles (3 indices per triangle)
-    std::vector<unsigned int> indices;
+struct ObjParseStats;
+class Texture;
 
+// A placed instance of a geometry: shared, immutable MeshData plus this
+// instance's transform node. Copying a mesh copies the transform and shares
+// the geometry, so memory grows with the number of unique assets rather than
+// with the number of instances.
+class Mesh {
 private:
-    // World space transformation properties
-    Vector3 worldPosition;    // Position in world space
-    Vector3 worldRotation;    // Rotation angles (Euler angles: X, Y, Z)
-    Vector3 worldScale;       // Scale factors (X, Y, Z)
+    // Never null; shared with copies of this mesh and with other instances
+    std::shared_ptr<const MeshData> geometry;
+
+    // Set when `geometry` was created by a mesh (and so may be edited in
+    // place once no one else holds it); geometry from setGeometry() is
+    // always copied before the first edit
+    bool geometryWritable;
+
+    // Position, rotation and scale, relative to the parent node if there is one
+    Transform transform;
+
+    // Rasterized into the renderer's occlusion buffer before other meshes
+    bool occluder;
+
+    // Bumped whenever the geometry may have changed
+    unsigned int geometryVersion;
+
+    // Shared like the geometry; null draws the mesh untextured
+    std::shared_ptr<const Texture> texture;
 
 public:
-    Mesh() : worldPosition(0, 0, 0), worldRotation(0, 0, 0), worldScale(1, 1, 1) {}
+    Mesh();
+
+    // Shared geometry. setGeometry() makes this mesh another instance of it.
+    const MeshData& getGeometry() const { return *geometry; }
+    const std::shared_ptr<const MeshData>& getSharedGeometry() const { return geometry; }
+    void setGeometry(std::shared_ptr<const MeshData> data);
+
+    // Mutable geometry for editing. Copy-on-write: if other meshes share the
+    // geometry, this mesh gets a private copy first, so they are unaffected.
+    MeshData& editGeometry();
+
+    // Whether another mesh (or a getSharedGeometry() holder) uses the same geometry
+    bool isGeometryShared() const { return geometry.use_count() > 1; }
 
     // Add vertex to buffer and return its index
-    unsigned int addVertex(const Vertex& vertex);
+    unsigned int addVertex(const Vertex& vertex) { return editGeometry().addVertex(vertex); }
     
     // Add triangle using vertex indices (more efficient than storing duplicate vertices)
-    void addTriangle(unsigned int i0, unsigned int i1, unsigned int i2);
+    void addTriangle(unsigned int i0, unsigned int i1, unsigned int i2) { editGeometry().addTriangle(i0, i1, i2); }
     
-    // Add triangle by vertices (automatically handles indexing)
-    void addTriangle(const Triangle& tri);
+    // Add triangle by vertices (appends three new vertices; weld with MeshOptimizer)
+    void addTriangle(const Triangle& tri) { editGeometry().addTriangle(tri); }
     
     // Get triangle by index (reconstructed from vertex and index buffers)
-    Triangle getTriangle(size_t triangleIndex) const;
+    Triangle getTriangle(size_t triangleIndex) const { return geometry->getTriangle(triangleIndex); }
     
     // Get triangle in WORLD space (applies world transformation)
     Triangle getTriangleWorldSpace(size_t triangleIndex) const;
     
     // Get total number of triangles
-    size_t getTriangleCount() const { return indices.size() / 3; }
+    size_t getTriangleCount() const { return getIndexCount() / 3; }
     
-    // World space transformation properties (getters/setters)
-    void setWorldPosition(const Vector3& position) { worldPosition = position; }
-    void setWorldPosition(float x, float y, float z) { worldPosition = Vector3(x, y, z); }
-    const Vector3& getWorldPosition() const { return worldPosition; }
+    // Transform node, e.g. to parent the mesh to another node of a hierarchy
+    Transform& getTransform() { return transform; }
+    const Transform& getTransform() const { return transform; }
+
+    // World space transformation properties (getters/setters). With a parent
+    // node they are relative to it.
+    void setWorldPosition(const Vector3& position) { transform.setPosition(position); }
+    void setWorldPosition(float x, float y, float z) { transform.setPosition(Vector3(x, y, z)); }
+    const Vector3& getWorldPosition() const { return transform.getPosition(); }
     
-    void setWorldRotation(const Vector3& rotation) { worldRotation = rotation; }
-    void setWorldRotation(float x, float y, float z) { worldRotation = Vector3(x, y, z); }
-    const Vector3& getWorldRotation() const { return worldRotation; }
+    void setWorldRotation(const Vector3& rotation) { transform.setRotation(rotation); }
+    void setWorldRotation(float x, float y, float z) { transform.setRotation(Vector3(x, y, z)); }
+    const Vector3& getWorldRotation() const { return transform.getRotation(); }
     
-    void setWorldScale(const Vector3& scale) { worldScale = scale; }
-    void setWorldScale(float x, float y, float z) { worldScale = Vector3(x, y, z); }
-    void setWorldScale(float uniformScale) { worldScale = Vector3(uniformScale, uniformScale, uniformScale); }
-    const Vector3& getWorldScale() const { return worldScale; }
+    void setWorldScale(const Vector3& scale) { transform.setScale(scale); }
+    void setWorldScale(float x, float y, float z) { transform.setScale(Vector3(x, y, z)); }
+    void setWorldScale(float uniformScale) { transform.setScale(Vector3(uniformScale, uniformScale, uniformScale)); }
+    const Vector3& getWorldScale() const { return transform.getScale(); }
 
     // World space transformation methods (modify world properties, not geometry)
     void translateWorld(float x, float y, float z);
@@ -63,20 +99,73 @@ public:
     void scaleWorld(float sx, float sy, float sz);
     void scaleWorld(float uniformScale);
 
-    // Get the world transformation matrix
-    Matrix4 getWorldTransformMatrix() const;
+    // Get the world transformation matrix (cached by the transform node)
+    const Matrix4& getWorldTransformMatrix() const { return transform.getWorldMatrix(); }
     
+    // Occlusion culling role (large, solid meshes such as walls make good occluders)
+    void setOccluder(bool isOccluder) { occluder = isOccluder; }
+    bool isOccluder() const { return occluder; }
+
+    // Texture modulating the lit color in Renderer::render_Light (used when the
+    // geometry has texture coordinates)
+    void setTexture(std::shared_ptr<const Texture> meshTexture) { texture = std::move(meshTexture); }
+    const Texture* getTexture() const { return texture.get(); }
+    const std::shared_ptr<const Texture>& getSharedTexture() const { return texture; }
+
     // Transform a vertex from object space to world space
-    Vector3 transformToWorldSpace(const Vector3& localPos) const;
+    Vector3 transformToWorldSpace(const Vector3& localPos) const { return transform.transformPoint(localPos); }
 
-    // File I/O
-    bool loadFromOBJ(const std::string& filename);
+    // File I/O (see ObjParser for the supported subset; stats receive counts and timings)
+    bool loadFromOBJ(const std::string& filename, ObjParseStats* stats = nullptr);
     
-    // Utility methods
+    // Geometry access (see MeshData)
+    PositionStreamView getPositionStreamView() const { return geometry->getPositionStreamView(); }
+    bool isPositionStreamCurrent() const { return geometry->isPositionStreamCurrent(); }
+    void updatePositionStream() { editGeometry().updatePositionStream(); }
+    Vector3 getVertexPosition(size_t index) const { return geometry->getVertexPosition(index); }
+    Vertex getVertex(size_t index) const { return geometry->getVertex(index); }
+    const unsigned int* getIndexData() const { return geometry->getIndexData(); }
+
+    // Use externally owned geometry in place (see MeshData::attachExternalGeometry)
+    void attachExternalGeometry(std::shared_ptr<const void> owner,
+                                const float* x, const float* y, const float* z,
+                                size_t vertexCount, size_t paddedVertexCount,
+                                const unsigned int* indexData, size_t indexCount,
+                                const AABB& objectBounds, const BoundingSphere& objectSphere);
+    void attachExternalNormals(const float* nx, const float* ny, const float* nz) { editGeometry().attachExternalNormals(nx, ny, nz); }
+    void attachExternalTexCoords(const float* u, const float* v) { editGeometry().attachExternalTexCoords(u, v); }
+    bool hasExternalGeometry() const { return geometry->hasExternalGeometry(); }
+
+    bool hasVertexNormals() const { return geometry->hasVertexNormals(); }
+    bool hasTexCoords() const { return geometry->hasTexCoords(); }
+    void setVertexAttributes(bool normals, bool texCoords) { editGeometry().setVertexAttributes(normals, texCoords); }
+    void makeGeometryOwned();
+
+    const AABB& getBounds() const { return geometry->getBounds(); }
+    const BoundingSphere& getBoundingSphere() const { return geometry->getBoundingSphere(); }
+    void updateBounds() { editGeometry().updateBounds(); }
+
+    // Bounds after the world transformation
+    AABB getWorldBounds() const;
+    BoundingSphere getWorldBoundingSphere() const;
+
+    // Levels of detail (see MeshData)
+    size_t getLODCount() const { return geometry->getLODCount(); }
+    const unsigned int* getLODIndexData(size_t level) const { return geometry->getLODIndexData(level); }
+    size_t getLODTriangleCount(size_t level) const { return geometry->getLODTriangleCount(level); }
+    size_t getLODVertexCount(size_t level) const { return geometry->getLODVertexCount(level); }
+    float getLODError(size_t level) const { return geometry->getLODError(level); }
+    void setLODs(std::vector<MeshLOD> levels) { editGeometry().setLODs(std::move(levels)); }
+    void clearLODs();
+
+    // Changes whenever the world transform or the geometry may have changed (used by Scene to refit)
+    unsigned int getBoundsVersion() const { return geometryVersion + transform.getWorldVersion(); }
+
+    // Utility methods (clear() also resets the world transform)
     void clear();
-    void reserve(size_t vertexCount, size_t triangleCount);
+    void reserve(size_t vertexCount, size_t triangleCount) { editGeometry().reserve(vertexCount, triangleCount); }
     
     // Statistics
-    size_t getVertexCount() const { return vertices.size(); }
-    size_t getIndexCount() const { return indices.size(); }
+    size_t getVertexCount() const { return geometry->getVertexCount(); }
+    size_t getIndexCount() const { return geometry->getIndexCount(); }
 };
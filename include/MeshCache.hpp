@@ -0,0 +1,55 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "Mesh.hpp"
+
+// On-disk layout of a binary mesh cache file. All blocks start at multiples of
+// MeshCache::BLOCK_ALIGNMENT so the mapped data can be used by the SIMD
+// transform kernels directly.
+struct MeshCacheHeader {
+    char magic[8];                  // "MESHBIN\0"
+    uint32_t version;               // MeshCache::FORMAT_VERSION
+    uint32_t endianTag;             // MeshCache::ENDIAN_TAG in the writer's byte order
+    uint64_t fileSize;
+    uint64_t vertexCount;
+    uint64_t paddedVertexCount;     // Floats per position array (multiple of PositionStream::PADDING)
+    uint64_t indexCount;
+    uint64_t positionsOffset;       // x, y and z arrays back to back, paddedVertexCount floats each
+    uint64_t indicesOffset;         // indexCount 32-bit indices
+    uint64_t normalsOffset;         // Optional (0 if absent): nx, ny, nz arrays laid out like the positions
+    uint64_t texCoordsOffset;       // Optional (0 if absent): u and v arrays, paddedVertexCount floats each
+    uint64_t sourceSize;            // Source file size and modification time when the cache was
+    int64_t sourceTime;             // written (both 0 if there was no source)
+    float boundsMin[3];             // Object-space AABB and bounding sphere
+    float boundsMax[3];
+    float sphereCenter[3];
+    float sphereRadius;
+    uint32_t reserved[2];
+};
+
+// Binary mesh cache: converts OBJ files once and then loads them by mapping
+// the cache file and pointing the mesh at the mapped arrays (no parsing, no copy).
+class MeshCache {
+public:
+    static const uint32_t FORMAT_VERSION = 2;
+    static const uint32_t ENDIAN_TAG = 0x01020304;
+    static const size_t BLOCK_ALIGNMENT = 32;
+
+    // Write the mesh geometry, vertex attributes and bounds. When sourcePath is given, its size and
+    // modification time are stored so stale caches can be detected.
+    static bool write(const Mesh& mesh, const std::string& cachePath, const std::string& sourcePath = "");
+
+    // Map a cache file and attach its geometry to the mesh in place. Fails on a
+    // missing, truncated or foreign file, on indices outside the vertex range, or
+    // when sourcePath changed since the cache was written.
+    static bool read(const std::string& cachePath, Mesh& mesh, const std::string& sourcePath = "");
+
+    // Parse an OBJ file and write its cache
+    static bool convertOBJ(const std::string& objPath, const std::string& cachePath);
+
+    // Load through the cache, falling back to the OBJ (and regenerating the
+    // cache) when the cache is missing or out of date
+    static bool load(const std::string& objPath, Mesh& mesh, const std::string& cachePath = "");
+
+    static std::string getDefaultCachePath(const std::string& objPath) { return objPath + ".meshbin"; }
+};
@@ -0,0 +1,164 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include "Triangle.hpp"
+#include "Vertex.hpp"
+#include "Vector3.hpp"
+#include "AlignedAllocator.hpp"
+#include "Bounds.hpp"
+
+// Simplified version of a mesh's triangles (see MeshSimplifier). Vertices are
+// ordered so that every level only references a prefix of the vertex buffer.
+struct MeshLOD {
+    std::vector<unsigned int> indices;
+    size_t vertexCount = 0;     // Indices stay below this
+    float error = 0.0f;         // Object-space deviation from the full mesh
+};
+
+// Structure-of-arrays copy of mesh vertex positions for batched transforms.
+// Arrays are 32-byte aligned and zero-padded to a multiple of PADDING floats.
+struct PositionStream {
+    static const size_t PADDING = 8;
+
+    AlignedFloatVector x, y, z;
+    size_t count = 0;   // Number of real positions (arrays may be longer)
+};
+
+// Read-only view of SoA positions, owned by the mesh or stored externally
+struct PositionStreamView {
+    const float* x;
+    const float* y;
+    const float* z;
+    size_t count;           // Number of real positions
+    size_t paddedCount;     // Readable floats per array (a multiple of PositionStream::PADDING)
+};
+
+// Object-space geometry of a mesh: vertex and index buffers plus everything
+// derived from them (position stream, bounds, levels of detail).
+//
+// Meshes hold it through a std::shared_ptr<const MeshData>, so copies of a
+// mesh (instances) share one geometry and only own their transform. See
+// Mesh::editGeometry() for copy-on-write.
+class MeshData {
+public:
+    // Vertex buffer: stores unique vertices in LOCAL/OBJECT space
+    std::vector<Vertex> vertices;
+
+    // Index buffer: stores indices that form triangles (3 indices per triangle)
+    std::vector<unsigned int> indices;
+
+private:
+    // SoA position stream mirroring `vertices`
+    PositionStream positions;
+
+    // Object-space bounds of `vertices`
+    AABB bounds;
+    BoundingSphere boundingSphere;
+
+    // Which Vertex attributes beyond the position carry data
+    bool vertexNormals;
+    bool vertexTexCoords;
+
+    // Geometry living outside the mesh (e.g. a memory-mapped cache file).
+    // While attached, `vertices` and `indices` stay empty and the accessors
+    // below read these arrays instead.
+    struct ExternalGeometry {
+        std::shared_ptr<const void> owner;  // Keeps the memory alive; null when not attached
+        const float* x = nullptr;
+        const float* y = nullptr;
+        const float* z = nullptr;
+        size_t vertexCount = 0;
+        size_t paddedVertexCount = 0;
+        const unsigned int* indices = nullptr;
+        size_t indexCount = 0;
+        const float* nx = nullptr;      // Optional attribute arrays (null when absent)
+        const float* ny = nullptr;
+        const float* nz = nullptr;
+        const float* u = nullptr;
+        const float* v = nullptr;
+    };
+    ExternalGeometry external;
+
+    // Levels of detail beyond the full index buffer (level 0), finest first
+    std::vector<MeshLOD> lods;
+
+public:
+    MeshData() : vertexNormals(false), vertexTexCoords(false) {}
+
+    // Add vertex to buffer and return its index
+    unsigned int addVertex(const Vertex& vertex);
+
+    // Add triangle using vertex indices (more efficient than storing duplicate vertices)
+    void addTriangle(unsigned int i0, unsigned int i1, unsigned int i2);
+
+    // Add triangle by vertices (appends three new vertices; weld with MeshOptimizer)
+    void addTriangle(const Triangle& tri);
+
+    // Get triangle by index (reconstructed from vertex and index buffers)
+    Triangle getTriangle(size_t triangleIndex) const;
+
+    // Get total number of triangles
+    size_t getTriangleCount() const { return getIndexCount() / 3; }
+
+    // SoA positions, maintained by addVertex/clear.
+    // Call updatePositionStream() after editing `vertices` directly.
+    PositionStreamView getPositionStreamView() const;
+    bool isPositionStreamCurrent() const { return hasExternalGeometry() || positions.count == vertices.size(); }
+    void updatePositionStream();
+
+    // Geometry access that works for owned and external storage
+    Vector3 getVertexPosition(size_t index) const;
+    Vector3 getVertexNormal(size_t index) const;
+    void getVertexTexCoord(size_t index, float& u, float& v) const;
+    Vertex getVertex(size_t index) const;
+    const unsigned int* getIndexData() const { return hasExternalGeometry() ? external.indices : indices.data(); }
+
+    // Use externally owned geometry in place (no copy). `owner` keeps the memory
+    // alive and is shared by copies. Position arrays must be padded to
+    // paddedVertexCount floats.
+    void attachExternalGeometry(std::shared_ptr<const void> owner,
+                                const float* x, const float* y, const float* z,
+                                size_t vertexCount, size_t paddedVertexCount,
+                                const unsigned int* indexData, size_t indexCount,
+                                const AABB& objectBounds, const BoundingSphere& objectSphere);
+    // Optional external normals (SoA) and texture coordinates, after attachExternalGeometry()
+    void attachExternalNormals(const float* nx, const float* ny, const float* nz);
+    void attachExternalTexCoords(const float* u, const float* v);
+    bool hasExternalGeometry() const { return external.owner != nullptr; }
+
+    // Whether vertex normals / texture coordinates were provided (e.g. by vn/vt in the OBJ)
+    bool hasVertexNormals() const { return vertexNormals; }
+    bool hasTexCoords() const { return vertexTexCoords; }
+    void setVertexAttributes(bool normals, bool texCoords) { vertexNormals = normals; vertexTexCoords = texCoords; }
+
+    // Copy external geometry into `vertices`/`indices` so it can be edited
+    // (done automatically by the mutating methods)
+    void makeGeometryOwned();
+
+    // Object-space bounds, maintained like the position stream.
+    // Call updateBounds() after editing `vertices` directly.
+    const AABB& getBounds() const { return bounds; }
+    const BoundingSphere& getBoundingSphere() const { return boundingSphere; }
+    void updateBounds();
+
+    // Levels of detail. Level 0 is the full index buffer; coarser levels share the
+    // vertex buffer and are dropped by edits to the triangles.
+    size_t getLODCount() const { return 1 + lods.size(); }
+    const unsigned int* getLODIndexData(size_t level) const { return level == 0 ? getIndexData() : lods[level - 1].indices.data(); }
+    size_t getLODTriangleCount(size_t level) const { return level == 0 ? getTriangleCount() : lods[level - 1].indices.size() / 3; }
+    size_t getLODVertexCount(size_t level) const { return level == 0 ? getVertexCount() : lods[level - 1].vertexCount; }
+    float getLODError(size_t level) const { return level == 0 ? 0.0f : lods[level - 1].error; }
+    void setLODs(std::vector<MeshLOD> levels) { lods = std::move(levels); }
+    void clearLODs() { lods.clear(); }
+
+    // Utility methods
+    void clear();
+    void reserve(size_t vertexCount, size_t triangleCount);
+
+    // Statistics
+    size_t getVertexCount() const { return hasExternalGeometry() ? external.vertexCount : vertices.size(); }
+    size_t getIndexCount() const { return hasExternalGeometry() ? external.indexCount : indices.size(); }
+
+    // Approximate heap memory held by this geometry (external memory not included)
+    size_t getMemoryUsage() const;
+};
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include "Mesh.hpp"
+
+// Before/after figures of MeshOptimizer::optimize()
+struct MeshOptimizeStats {
+    size_t verticesBefore = 0;
+    size_t verticesAfter = 0;
+    size_t trianglesBefore = 0;
+    size_t trianglesAfter = 0;      // Triangles collapsed by welding are removed
+    float acmrBefore = 0.0f;        // Average cache miss ratio (vertex transforms per triangle)
+    float acmrAfter = 0.0f;
+};
+
+// Offline mesh clean-up passes. All of them edit the mesh's owned geometry
+// (external geometry is copied first) and keep the rendered surface unchanged.
+// Levels of detail are dropped, so run MeshSimplifier::generateLODs() afterwards.
+class MeshOptimizer {
+public:
+    // FIFO post-transform cache size assumed by the reordering and by computeACMR()
+    static const unsigned int DEFAULT_CACHE_SIZE = 16;
+
+    // Run every pass in order: weld, vertex cache, overdraw, vertex fetch
+    static MeshOptimizeStats optimize(Mesh& mesh, float weldTolerance = 0.0f,
+                                      unsigned int cacheSize = DEFAULT_CACHE_SIZE);
+
+    // Merge vertices whose position, normal and texture coordinates all differ
+    // by at most `tolerance` per component (0 merges exact duplicates only), and
+    // drop triangles that collapse as a result. Returns the number of vertices removed.
+    static size_t weldVertices(Mesh& mesh, float tolerance = 0.0f);
+
+    // Reorder triangles for post-transform vertex cache hits (Tipsify)
+    static void optimizeVertexCache(Mesh& mesh, unsigned int cacheSize = DEFAULT_CACHE_SIZE);
+
+    // Reorder the clusters produced by optimizeVertexCache() so that outward
+    // facing parts of the mesh are drawn first, letting the depth test reject
+    // more of what is drawn behind them
+    static void optimizeOverdraw(Mesh& mesh, unsigned int cacheSize = DEFAULT_CACHE_SIZE);
+
+    // Renumber vertices in order of first use by the index buffer and drop
+    // unreferenced ones, so vertex reads walk memory mostly forwards
+    static void optimizeVertexFetch(Mesh& mesh);
+
+    // Vertices transformed per triangle with a FIFO cache of `cacheSize` entries
+    // (0.5 is the ideal for large regular meshes, 3.0 means no reuse at all)
+    static float computeACMR(const unsigned int* indices, size_t indexCount, size_t vertexCount,
+                             unsigned int cacheSize = DEFAULT_CACHE_SIZE);
+};
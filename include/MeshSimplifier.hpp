@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "Mesh.hpp"
+
+// Quadric error metric simplification (Garland and Heckbert, "Surface
+// Simplification Using Quadric Error Metrics") with half-edge collapses:
+// vertices are merged into a neighbour and never moved, so every simplified
+// index buffer can share the mesh's vertex buffer.
+//
+// Vertices on open borders only slide along the border, and vertices that
+// share their position with another vertex (attribute seams) are kept.
+class MeshSimplifier {
+public:
+    static const size_t DEFAULT_MAX_LODS = 4;
+
+    // Levels with fewer triangles than this are not generated
+    static const size_t MIN_LOD_TRIANGLES = 16;
+
+    // Collapse edges of the triangle list until at most targetIndexCount indices
+    // remain, or until the cheapest collapse would move the surface by more than
+    // maxError (object-space units). *resultError receives the largest error made.
+    static std::vector<unsigned int> simplify(const Mesh& mesh, const unsigned int* indices, size_t indexCount,
+                                              size_t targetIndexCount, float maxError,
+                                              float* resultError = nullptr);
+
+    // Replace the mesh's levels of detail with a chain where each level has about
+    // `reduction` times the triangles of the previous one. The vertex buffer is
+    // reordered so that each level only uses a prefix of it. Returns the number
+    // of levels beyond the full mesh.
+    static size_t generateLODs(Mesh& mesh, size_t maxLevels = DEFAULT_MAX_LODS, float reduction = 0.5f,
+                               float maxError = 1e30f);
+};
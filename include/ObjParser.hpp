@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Vertex.hpp"
+
+class ThreadPool;
+
+// Geometry produced by ObjParser: one Vertex per unique v/vt/vn combination
+// and a triangle list indexing them
+struct ObjMeshData {
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    bool hasNormals = false;        // Some face corner referenced a vn
+    bool hasTexCoords = false;      // Some face corner referenced a vt
+};
+
+// Content and throughput counters for one import
+struct ObjParseStats {
+    size_t bytes = 0;
+    size_t positions = 0;           // v records
+    size_t texCoords = 0;           // vt records
+    size_t normals = 0;             // vn records
+    size_t faces = 0;               // f records, before triangulation
+    size_t skippedFaces = 0;        // Malformed or out-of-range faces
+    size_t triangles = 0;
+    size_t vertices = 0;            // Unique vertices in the result
+    size_t chunks = 0;
+    double seconds = 0.0;
+
+    double getMegabytesPerSecond() const;
+    double getVerticesPerSecond() const;    // Input positions per second
+};
+
+// Wavefront OBJ reader. The file is memory mapped and split at line breaks
+// into chunks that are parsed in parallel; the chunks are merged in file
+// order, so the result does not depend on the number of threads.
+//
+// Supports v, vt, vn and f records (v, v/vt, v//vn and v/vt/vn corners,
+// negative relative indices, polygons of any size, fan triangulated).
+// Everything else (groups, materials, lines, ...) is ignored.
+class ObjParser {
+public:
+    // Chunks are at least this large; smaller files are parsed on the calling thread
+    static const size_t MIN_CHUNK_BYTES = 1 << 20;
+
+    // threadCount == 0 uses one thread per hardware thread
+    explicit ObjParser(size_t threadCount = 0);
+    ~ObjParser();
+
+    ObjParser(const ObjParser&) = delete;
+    ObjParser& operator=(const ObjParser&) = delete;
+
+    bool parse(const std::string& filename, ObjMeshData& data, ObjParseStats* stats = nullptr);
+
+    // Parse OBJ text already in memory
+    bool parse(const char* text, size_t length, ObjMeshData& data, ObjParseStats* stats = nullptr);
+
+private:
+    size_t threadCount;
+    std::unique_ptr<ThreadPool> pool;   // Created on the first file large enough to split
+};
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Vector3.hpp"
+
+// Coarse, conservative depth buffer for software occlusion culling.
+// Each cell covers CELL_SIZE x CELL_SIZE screen pixels and stores the farthest
+// depth any occluder is known to reach across the whole cell. Coverage is
+// gathered per pixel, with the rasterizer's vertex snapping and fill rule: a
+// cell keeps a mask of the pixels occluder triangles have covered so far and the farthest depth among those triangles, and takes that
+// depth once the mask is full. Triangles that share an edge therefore fill the
+// cells along it together, and a cell's depth never claims more occlusion than
+// the full-resolution image would show.
+class OcclusionBuffer {
+public:
+    static const int CELL_SIZE = 4;
+
+    OcclusionBuffer(int screenWidth, int screenHeight);
+
+    // Reset every cell to "nothing in front"
+    void clear();
+
+    // Rasterize an occluder triangle given in screen space (z = NDC depth)
+    void rasterizeOccluder(const Vector3& v0, const Vector3& v1, const Vector3& v2);
+
+    // True when every cell overlapping the inclusive pixel rectangle holds an
+    // occluder nearer than minDepth. Rectangles entirely off-screen are not
+    // reported as occluded (they are left to the clipper).
+    bool isRectOccluded(float minX, float minY, float maxX, float maxY, float minDepth) const;
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    const std::vector<float>& getDepth() const { return depth; }
+
+private:
+    // Coverage bits of the cell's pixels that lie off-screen
+    std::uint16_t offscreenCoverage(int cx, int cy) const;
+
+    int screenWidth;
+    int screenHeight;
+    int width;      // Cells per row
+    int height;     // Cell rows
+    std::vector<float> depth;
+    
+    // Pixels covered since the cell's depth was last written (bit y * CELL_SIZE + x;
+    // pixels past the screen edge start set) and the farthest depth covering them
+    std::vector<std::uint16_t> coverage;
+    std::vector<float> coverageDepth;
+};
@@ -1,55 +1,283 @@
 #pragma once
+#include <cstdint>
 #include <vector>
+#include <string>
+#include <memory>
+#include <unordered_map>
 #include "Mesh.hpp"
 #include "Camera.hpp"
 #include "Vector3.hpp"
+#include "Vector4.hpp"
 #include "Color.hpp"
+#include "LinearColor.hpp"
+#include "AccumulationBuffer.hpp"
 #include "Light.hpp"
 #include "Material.hpp"
+#include "Texture.hpp"
+#include "LightingEngine.hpp"
+#include "FrameStats.hpp"
+#include "ThreadPool.hpp"
+#include "OcclusionBuffer.hpp"
+#include "Frustum.hpp"
+#include "Scene.hpp"
 
 // Forward declaration for minimal SFML usage
+// (building with -DHEADLESS drops the SFML display path entirely)
+#ifndef HEADLESS
 namespace sf {
     class RenderWindow;
-    class Image;
     class Texture;
     class Sprite;
 }
+#endif
 
 class Renderer
 {
+    // Microbenchmarks call the rasterizers directly (bench/bench_micro.cpp)
+    friend struct RendererBenchAccess;
+
 public:
     Renderer(int width, int height);
     ~Renderer();
 
     void clear(const Color& clearColor = Color(0, 0, 0));
     void render_Mesh(const std::vector<Mesh>& meshes, const Camera& camera);
+    // Lit meshes with a texture (Mesh::setTexture) and texture coordinates are
+    // drawn with the texture modulating their lit color
     void render_Light(const std::vector<Mesh>& meshes, const Camera& camera, 
                       const std::vector<Light>& lights, const Material& material);
+
+    // Scene versions: update the scene's hierarchy and only visit the meshes it
+    // reports inside the view frustum
+    void render_Mesh(Scene& scene, const Camera& camera);
+    void render_Light(Scene& scene, const Camera& camera,
+                      const std::vector<Light>& lights, const Material& material);
+
+    // Instanced versions: draw one shared geometry once per world transform.
+    // Object-space work is done once per call (bounds are shared, face normals
+    // are computed once and rotated per instance) instead of once per instance.
+    // A texture applies to every instance, as with Mesh::setTexture.
+    void render_MeshInstanced(const MeshData& geometry, const std::vector<Matrix4>& instanceTransforms,
+                              const Camera& camera);
+    void render_LightInstanced(const MeshData& geometry, const std::vector<Matrix4>& instanceTransforms,
+                               const Camera& camera, const std::vector<Light>& lights,
+                               const Material& material, const Texture* texture = nullptr);
+#ifndef HEADLESS
     void present(sf::RenderWindow& window);
+    // Present pixels resolved elsewhere (e.g. a FramePipeline frame). Only uses
+    // the display objects, so it may run while another thread renders.
+    void present(sf::RenderWindow& window, const std::vector<std::uint32_t>& framePixels);
+#endif
+
+    // Render passes accumulate into a float color buffer. resolve() converts it
+    // to the RGBA8 pixels used by present(), getPixels() and saveToPPM(): call
+    // it once the frame is drawn. The overload resolves into another buffer.
+    void resolve();
+    void resolve(std::vector<std::uint32_t>& target);
+    void setToneMapping(AccumulationBuffer::ToneMapping mode, float whitePoint = 2.0f) {
+        colorBuffer.setToneMapping(mode, whitePoint);
+    }
+
+    // Offscreen access to the resolved frame (no SFML required)
+    int getWidth() const { return screenWidth; }
+    int getHeight() const { return screenHeight; }
+    const std::vector<std::uint32_t>& getPixels() const { return pixels; }   // See AccumulationBuffer::resolve
+    bool saveToPPM(const std::string& filename) const;
+    bool saveToPPM(const std::string& filename, const std::vector<std::uint32_t>& framePixels) const;
+
+    // Rasterization threading (1 = serial, 0 = one thread per hardware core)
+    void setThreadCount(int threadCount);
+    int getThreadCount() const;
+
+    // Occlusion culling: occluders are rasterized into a coarse depth buffer before
+    // each pass and meshes hidden behind them are skipped. Occluders are the meshes
+    // marked with Mesh::setOccluder, or the nearest meshes (or instances) when none
+    // are marked.
+    void setOcclusionCulling(bool enabled) { occlusionCulling = enabled; }
+    bool isOcclusionCullingEnabled() const { return occlusionCulling; }
+    const OcclusionBuffer& getOcclusionBuffer() const { return occlusionBuffer; }
+
+    // Level of detail: each mesh is drawn with its coarsest level whose error
+    // projects to at most this many pixels (0 always draws full detail)
+    void setLODPixelError(float pixels) { lodPixelError = pixels; }
+    float getLODPixelError() const { return lodPixelError; }
+
+    // Whole-mesh culling counters for the last render pass (instances count as meshes)
+    struct CullStats {
+        size_t meshesTested = 0;
+        size_t meshesRendered = 0;
+        size_t frustumCulled = 0;       // Bounds entirely outside the view frustum
+        size_t occlusionCulled = 0;     // Hidden behind occluders
+        size_t trianglesCulled = 0;     // Triangles of all culled meshes
+        size_t lodTrianglesSkipped = 0; // Triangles saved by drawing coarser levels of detail
+    };
+    const CullStats& getCullStats() const { return cullStats; }
+
+    // Gouraud lighting work for the last lit render pass
+    struct LightingStats {
+        size_t corners = 0;         // Triangle corners drawn
+        size_t litVertices = 0;     // Lighting evaluations (unique vertex and normal pairs)
+    };
+    const LightingStats& getLightingStats() const { return lightingStats; }
+
+    // Statistics of the current frame (clear() starts a new one). Complete once
+    // the frame is resolved; all zero when built with FRAME_STATS=0.
+    const FrameStats& getFrameStats() const { return frameStats; }
+
+    // Number of nearest meshes used as occluders when none are marked
+    static constexpr size_t DEFAULT_OCCLUDER_COUNT = 8;
+
+    // Screen is binned into square tiles of this size for parallel rasterization
+    static const int TILE_SIZE = 64;
+    
+    // Geometry may extend this many pixels past each screen edge without being clipped
+    static const int GUARD_BAND_PIXELS = 8192;
 
 private:
-    // Core pipeline stages
+    // Inclusive pixel rectangle that rasterization is restricted to
+    struct ScreenRect {
+        int minX, minY, maxX, maxY;
+    };
+
+    // Deferred rasterization work, recorded in submission order
+    struct RasterCommand {
+        enum Type { FlatTriangle, GouraudTriangle, TexturedTriangle, DepthLine };
+        Type type;
+        Vector3 v0, v1, v2;     // Screen-space vertices (lines use v0 and v1)
+        LinearColor c0, c1, c2; // Flat triangles and lines only use c0
+        Vector3 t0, t1, t2;     // Textured triangles: (u / w, v / w, 1 / w) per vertex
+        const Texture* texture; // Textured triangles only
+    };
+
+    // Outcode flags for a vertex in homogeneous clip space
+    enum ClipFlags : unsigned char {
+        CLIP_LEFT   = 1 << 0,   // x < -w
+        CLIP_RIGHT  = 1 << 1,   // x > w
+        CLIP_BOTTOM = 1 << 2,   // y < -w
+        CLIP_TOP    = 1 << 3,   // y > w
+        CLIP_NEAR   = 1 << 4,   // z < -w (in front of the near plane or behind the camera)
+        CLIP_FAR    = 1 << 5,   // z > w
+        CLIP_GUARD  = 1 << 6,   // Outside the guard band
+        
+        CLIP_PLANES   = CLIP_LEFT | CLIP_RIGHT | CLIP_BOTTOM | CLIP_TOP | CLIP_NEAR | CLIP_FAR,
+        CLIP_REQUIRED = CLIP_NEAR | CLIP_GUARD   // Triangle must go through the clipper
+    };
+
+    // Post-transform vertex cache entry
+    struct TransformedVertex {
+        Vector4 clip;           // Homogeneous clip-space position
+        Vector3 screen;         // Viewport position, z keeps NDC depth (unset if CLIP_REQUIRED)
+        unsigned char outcode;  // ClipFlags
+    };
+
+    // A geometry placed in the world: a mesh, or one instance of an instanced call
+    struct DrawItem {
+        const MeshData* geometry;
+        Matrix4 worldMatrix;
+        size_t colorIndex;          // Palette slot (mesh or instance index)
+        unsigned char* lodLevel;    // Level drawn last frame, updated by selectLOD()
+        bool occluder;
+        const Texture* texture;     // Null when untextured
+    };
+
+    // Lit color buffer entry: one per unique (vertex, normal) of the mesh being drawn
+    struct LitEntry {
+        Vector3 normal;         // World space
+        unsigned int vertex;
+        unsigned int next;      // Next entry of the same vertex (~0u ends the list)
+    };
+
+    // Visible triangle of a lit pass with the lit color slots of its corners
+    struct LitTriangle {
+        unsigned int vertices[3];
+        unsigned int slots[3];  // Into litColors
+        bool clipped;           // Needs the clipper (visibility is tested afterwards)
+    };
+
+    // Depth test counts of a rasterizer call sequence (see FrameStats)
+    struct PixelCounters {
+        size_t tested = 0;
+        size_t passed = 0;
+    };
+
+    // Screen tile with the commands that overlap it
+    struct Tile {
+        ScreenRect bounds;
+        std::vector<unsigned int> commands;
+        PixelCounters counters;     // Of the last flush
+    };
+
+    // Why a triangle is not drawn (see FrameStats)
+    enum class TriangleTest { Visible, BehindCamera, OffScreen, BackFace, Degenerate };
+
+    // Raster command queue
+    void submitFlatTriangle(const Vector3& v0, const Vector3& v1, const Vector3& v2, const LinearColor& color);
+    void submitGouraudTriangle(const Vector3& v0, const Vector3& v1, const Vector3& v2,
+                               const LinearColor& c0, const LinearColor& c1, const LinearColor& c2);
+    void submitTexturedTriangle(const Vector3& v0, const Vector3& v1, const Vector3& v2,
+                                const LinearColor& c0, const LinearColor& c1, const LinearColor& c2,
+                                const Vector3& t0, const Vector3& t1, const Vector3& t2, const Texture& texture);
+    void submitDepthLine(const Vector3& v0, const Vector3& v1, const LinearColor& color);
+    void flushRasterCommands();
+    void executeRasterCommand(const RasterCommand& command, const ScreenRect& clip, PixelCounters& counters);
+    ScreenRect getCommandBounds(const RasterCommand& command) const;
+    void initTiles();
+
+    // Core pipeline stages (transforms cover the first `count` vertices of the mesh)
+    void transformVertices(const MeshData& mesh, const Matrix4& mvpMatrix, size_t count);
+    void transformVerticesToWorld(const MeshData& mesh, const Matrix4& worldMatrix, size_t count);
+    void transformPositions(const MeshData& mesh, const Matrix4& matrix, size_t count,
+                            const float*& outX, const float*& outY, const float*& outZ);
+    void transformPositionsHomogeneous(const MeshData& mesh, const Matrix4& matrix, size_t count,
+                                       const float*& outX, const float*& outY,
+                                       const float*& outZ, const float*& outW);
     Vector3 viewportTransform(const Vector3& clipSpaceVertex);
+    
+    // Render passes over the gathered draw items (frustum == nullptr when already
+    // frustum tested; objectNormals: light with getObjectFaceNormals(), see render_LightInstanced)
+    void selectAllMeshes(const std::vector<Mesh>& meshes);
+    void selectVisibleMeshes(Scene& scene, const Camera& camera);
+    void selectInstances(const MeshData& geometry, const std::vector<Matrix4>& instanceTransforms,
+                         const Texture* texture);
+    void drawMeshes(const Camera& camera, const Frustum* frustum);
+    void drawLitMeshes(const Camera& camera, const Frustum* frustum,
+                       const std::vector<Light>& lights, const Material& material, bool objectNormals);
+    const Vector3* getObjectFaceNormals(const MeshData& geometry, size_t level);
+
+    // Mesh culling (returns true and updates cullStats when the mesh can be skipped)
+    bool cullMesh(const MeshData& mesh, const Matrix4& worldMatrix, const Matrix4& mvpMatrix,
+                  const Frustum* frustum);
+    bool isMeshInFrustum(const MeshData& mesh, const Matrix4& worldMatrix, const Frustum& frustum) const;
+    bool isMeshOccluded(const MeshData& mesh, const Matrix4& mvpMatrix);
+    size_t selectLOD(const DrawItem& item, const Camera& camera);
+    void buildOcclusionBuffer(const Camera& camera, const Frustum* frustum, const Matrix4& viewProjMatrix);
 
     // Rasterization helpers
-    void drawLine_Bresenham(int x0, int y0, int x1, int y1, const Color& color);
-    void drawLine_Bresenham_Depth(int x0, int y0, int x1, int y1, float z0, float z1, const Color& color);
-    void fillTriangle_Scanline(const Vector3& v0, const Vector3& v1, const Vector3& v2, const Color& color);
+    void drawLine_Bresenham(int x0, int y0, int x1, int y1, const LinearColor& color);
+    void drawLine_Bresenham_Depth(int x0, int y0, int x1, int y1, float z0, float z1, const LinearColor& color,
+                                  const ScreenRect& clip, PixelCounters& counters);
+    void fillTriangle_Scanline(const Vector3& v0, const Vector3& v1, const Vector3& v2, const LinearColor& color,
+                               const ScreenRect& clip, PixelCounters& counters);
     void fillTriangle_Gouraud(const Vector3& v0, const Vector3& v1, const Vector3& v2, 
-                              const Color& c0, const Color& c1, const Color& c2);
+                              const LinearColor& c0, const LinearColor& c1, const LinearColor& c2,
+                              const ScreenRect& clip, PixelCounters& counters);
+    void fillTriangle_Textured(const Vector3& v0, const Vector3& v1, const Vector3& v2,
+                               const LinearColor& c0, const LinearColor& c1, const LinearColor& c2,
+                               const Vector3& t0, const Vector3& t1, const Vector3& t2, const Texture& texture,
+                               const ScreenRect& clip, PixelCounters& counters);
     
     // Lighting helpers
     Vector3 calculateFaceNormal(const Vector3& v0, const Vector3& v1, const Vector3& v2);
-    Color computeVertexLighting(const Vector3& worldPos, const Vector3& normal, 
-                                const Vector3& viewPos, const std::vector<Light>& lights, 
-                                const Material& material);
     
     // Pixel operations
-    void setPixel(int x, int y, const Color& color);
+    void setPixel(int x, int y, const LinearColor& color);
     
     // Culling and clipping
     bool isBackFace(const Vector3& v0, const Vector3& v1, const Vector3& v2);
     bool isTriangleVisible(const Vector3& v0, const Vector3& v1, const Vector3& v2);
+    TriangleTest testTriangle(const Vector3& v0, const Vector3& v1, const Vector3& v2);
+    TriangleTest testOutcodes(unsigned char outcode0, unsigned char outcode1, unsigned char outcode2) const;
+    void countCulledTriangle(TriangleTest reason);
 
     // Depth buffering
     void initZBuffer();
@@ -59,14 +287,62 @@ private:
     int screenWidth;
     int screenHeight;
     
-    // Frame buffer (raw pixel data)
-    std::vector<Color> frameBuffer;
+    // Frame buffer: float accumulation, and the RGBA8 pixels resolved from it
+    AccumulationBuffer colorBuffer;
+    std::vector<std::uint32_t> pixels;
     
     // Depth buffer
     std::vector<float> zBuffer;
     
-    // Minimal SFML objects for display only
-    sf::Image* displayImage;
-    sf::Texture* displayTexture;
-    sf::Sprite* displaySprite;
+    // Post-transform vertex cache for the mesh being rendered (reused across meshes)
+    std::vector<TransformedVertex> transformedVertices;
+    std::vector<Vector3> worldVertices;
+    
+    // Lighting stage of the mesh being rendered: corners index litColors
+    std::vector<LitTriangle> litTriangles;
+    std::vector<LitEntry> litEntries;
+    std::vector<unsigned int> litVertexHeads;   // First LitEntry per vertex
+    std::vector<LinearColor> litColors;
+    AlignedFloatVector litPositionX, litPositionY, litPositionZ;   // SoA copy of litEntries for the lighting kernel
+    AlignedFloatVector litNormalX, litNormalY, litNormalZ;
+    LightingEngine lightingEngine;
+    LightingStats lightingStats;
+    AlignedFloatVector transformedX, transformedY, transformedZ, transformedW;   // Batched transform output
+    
+    // Guard band extent in NDC units (triangles inside it skip clipping)
+    float guardBandX;
+    float guardBandY;
+    
+    // Statistics of the current frame
+    FrameStats frameStats;
+    
+    // Culling state
+    CullStats cullStats;
+    std::vector<DrawItem> drawItems;            // Meshes or instances drawn by the current pass
+    std::vector<size_t> visibleMeshIndices;     // Scene query results
+    OcclusionBuffer occlusionBuffer;
+    bool occlusionCulling;
+    std::vector<size_t> occluderIndices;        // Into drawItems
+    
+    // Level of detail state
+    float lodPixelError;
+    std::vector<unsigned char> meshLODLevels;   // Level drawn last frame, per mesh index
+    std::unordered_map<const MeshData*, std::vector<unsigned char>> instanceLODLevels; // Per instance index
+    
+    // Unit object-space face normals of the instanced geometry per level of
+    // detail, computed on first use in each instanced call
+    std::vector<std::vector<Vector3>> objectFaceNormals;
+    
+    // Binned rasterization state (reused across frames)
+    std::vector<RasterCommand> rasterCommands;
+    std::vector<Tile> tiles;
+    int tilesX;
+    int tilesY;
+    std::unique_ptr<ThreadPool> threadPool;
+    
+#ifndef HEADLESS
+    // Persistent display objects (the texture has the frame's size)
+    std::unique_ptr<sf::Texture> displayTexture;
+    std::unique_ptr<sf::Sprite> displaySprite;
+#endif
 };
@@ -0,0 +1,77 @@
+#pragma once
+#include <vector>
+#include "Mesh.hpp"
+#include "Bounds.hpp"
+#include "Frustum.hpp"
+
+// Mesh container with a bounding volume hierarchy over the meshes' world
+// bounds, so visibility queries only visit the parts of the scene that can
+// be seen instead of every mesh.
+//
+// Meshes are edited through getMesh(); update() then refits the leaves of the
+// meshes whose transform or geometry changed (see Mesh::getBoundsVersion)
+// and their ancestors. Meshes whose transform has a parent node can move
+// without being touched, so update() checks them every time. Adding meshes
+// triggers a full rebuild on the next update.
+class Scene {
+public:
+    // Meshes per leaf node
+    static const size_t LEAF_SIZE = 4;
+
+    Scene();
+
+    // Add a copy of the mesh and return its index
+    size_t addMesh(const Mesh& mesh);
+    void reserve(size_t meshCount);
+    void clear();
+
+    // Mutable access marks the mesh for refitting on the next update()
+    Mesh& getMesh(size_t index);
+    const Mesh& getMesh(size_t index) const { return meshes[index]; }
+    const std::vector<Mesh>& getMeshes() const { return meshes; }
+    size_t getMeshCount() const { return meshes.size(); }
+    size_t getTriangleCount() const { return triangleCount; }
+
+    // Bring the hierarchy up to date with the meshes (refit or rebuild)
+    void update();
+
+    // Build the hierarchy from scratch (better tree after large movements)
+    void rebuild();
+
+    // Append the indices of meshes whose world bounds intersect the frustum,
+    // in ascending order. Requires an up-to-date hierarchy.
+    void queryFrustum(const Frustum& frustum, std::vector<size_t>& meshIndices) const;
+
+    // World bounds of the whole scene
+    AABB getBounds() const;
+
+private:
+    struct Node {
+        AABB bounds;
+        int left;               // Child node indices (-1 for leaves)
+        int right;
+        int parent;             // -1 for the root
+        unsigned int first;     // Range of this subtree in meshOrder
+        unsigned int count;
+    };
+
+    int buildNode(unsigned int first, unsigned int count, int parent);
+    void refitLeaf(int nodeIndex);
+    void refitMesh(size_t index);
+
+    std::vector<Mesh> meshes;
+    std::vector<AABB> worldBounds;          // Per mesh, as of the last update
+    std::vector<unsigned int> meshVersions; // Mesh::getBoundsVersion() at the last update
+    std::vector<size_t> meshTriangles;      // Triangle count at the last update
+    size_t triangleCount;
+
+    std::vector<Node> nodes;
+    std::vector<unsigned int> meshOrder;    // Mesh indices ordered by leaf
+    std::vector<int> leafOfMesh;            // Leaf node holding each mesh
+
+    std::vector<size_t> touchedMeshes;      // Handed out through getMesh() since the last update
+    std::vector<bool> touched;
+    std::vector<size_t> childMeshes;        // Meshes seen with a parent transform node
+    std::vector<bool> isChildMesh;
+    bool needsRebuild;
+};
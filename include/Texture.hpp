@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "LinearColor.hpp"
+
+// Mipmapped RGBA8 texture sampled by the rasterizer (see Mesh::setTexture).
+//
+// Images are resampled to power-of-two sizes when loaded, and the whole mip
+// chain is built up front by 2x2 box filtering. Each level is stored in Morton
+// (Z) order, so texels that are close in both u and v share cache lines: the
+// 2x2 footprint of a bilinear fetch touches one or two lines whichever way a
+// triangle walks across the texture, where row-major storage would touch a
+// new line per row when walking along v.
+//
+// Texels are sRGB encoded, like the images they come from; resampling, mip
+// filtering and sample() work on their linear values (see LinearColor).
+// Texture coordinates repeat outside [0, 1]; v = 0 is the bottom row of the
+// image, as in OBJ files.
+class Texture {
+public:
+    Texture();
+
+    // Texels are RGBA8 in row-major order from the top row, R in the lowest
+    // byte (the layout of Renderer::getPixels). False for an empty image.
+    bool create(int width, int height, const std::uint32_t* rgba);
+
+    // Binary (P6) PPM with 8-bit channels, as written by Renderer::saveToPPM
+    bool loadFromPPM(const std::string& filename);
+#ifndef HEADLESS
+    // Any image format SFML reads (PNG, JPEG, BMP, ...)
+    bool loadFromFile(const std::string& filename);
+#endif
+
+    bool isEmpty() const { return levels.empty(); }
+    int getWidth() const { return levels.empty() ? 0 : levels[0].width; }     // Level 0, after resampling
+    int getHeight() const { return levels.empty() ? 0 : levels[0].height; }
+    int getLevelCount() const { return static_cast<int>(levels.size()); }
+    size_t getMemoryUsage() const;
+
+    // Mip level for a 2x2 pixel quad, from the change of (u, v) between
+    // horizontally and vertically adjacent pixels (nearest level)
+    int selectLevel(float dudx, float dvdx, float dudy, float dvdy) const;
+
+    // Bilinearly filtered linear color of one level (alpha is not used)
+    LinearColor sample(int level, float u, float v) const;
+
+    // Texel (x, y) of a level, counting rows from the bottom
+    std::uint32_t getTexel(int level, int x, int y) const {
+        const Level& mip = levels[level];
+        return texels[mip.offset + (mip.xBits[x] | mip.yBits[y])];
+    }
+
+private:
+    struct Level {
+        int width, height;
+        size_t offset;      // First texel in `texels`
+        // Morton index of texel (x, y) is xBits[x] | yBits[y]: x and y bits interleave
+        // (x at even positions) and the extra bits of the longer side go on top
+        std::vector<std::uint32_t> xBits, yBits;
+    };
+
+    // Build all levels from a power-of-two image (row-major, bottom row first)
+    void buildLevels(int width, int height, std::vector<std::uint32_t> image);
+
+    std::vector<Level> levels;
+    std::vector<std::uint32_t> texels;  // All levels, each in Morton order
+    const float* decodeTable;           // LinearColor's sRGB decode table
+};
@@ -0,0 +1,46 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool of worker threads for data-parallel loops.
+// The calling thread always takes part in the work, so a pool of size 1
+// spawns no threads and runs everything inline.
+class ThreadPool {
+public:
+    // threadCount == 0 picks std::thread::hardware_concurrency()
+    explicit ThreadPool(size_t threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Total number of threads working on a parallelFor (workers + caller)
+    size_t getThreadCount() const { return workers.size() + 1; }
+
+    // Run task(i) for every i in [0, count) and block until all are done.
+    // Indices are handed out dynamically, one at a time.
+    void parallelFor(size_t count, const std::function<void(size_t)>& task);
+
+private:
+    void workerLoop();
+    void runTasks();
+
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::condition_variable workFinished;
+
+    // Current job (guarded by mutex, except nextIndex)
+    const std::function<void(size_t)>* currentTask;
+    size_t taskCount;
+    std::atomic<size_t> nextIndex;
+    size_t busyWorkers;
+    unsigned long generation;
+    bool stopping;
+};
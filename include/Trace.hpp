@@ -0,0 +1,68 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Timeline tracing. TRACE_SCOPE("name") records how long the enclosing scope
+// took on the calling thread; Trace::writeJSON() exports the recorded events
+// in the Chrome trace event format (opens in ui.perfetto.dev or chrome://tracing).
+//
+// Every thread records into its own ring buffer holding its last CAPACITY
+// events, so recording takes no lock and the oldest events are overwritten.
+// A thread gets its ring on its first recorded event; when the thread exits,
+// its events are copied out and the ring is reused by later threads. Tracing
+// starts disabled; while disabled a scope costs one relaxed atomic load.
+// Event names must outlive the export (use string literals).
+class Trace {
+public:
+    static const size_t CAPACITY = 1 << 16;    // Events kept per thread
+
+    static void setEnabled(bool enable);
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+    // Name the calling thread in exported traces (threads are numbered otherwise)
+    static void setThreadName(const char* name);
+
+    // Drop the events recorded so far
+    static void clear();
+
+    // Write the recorded events of all threads. Events of threads that have
+    // exited are written once and then dropped. May be called while other
+    // threads keep recording.
+    static bool writeJSON(const std::string& filename);
+
+    // Trace clock in nanoseconds
+    static uint64_t now();
+
+    // Record a finished scope on the calling thread (see TraceScope)
+    static void record(const char* name, uint64_t start, uint64_t end);
+
+private:
+    static std::atomic<bool> enabled;
+};
+
+// Records its lifetime as a trace event, if tracing was enabled when it was created
+class TraceScope {
+public:
+    explicit TraceScope(const char* scopeName) : name(nullptr), start(0) {
+        if (Trace::isEnabled()) {
+            name = scopeName;
+            start = Trace::now();
+        }
+    }
+    ~TraceScope() {
+        if (name) Trace::record(name, start, Trace::now());
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name;
+    uint64_t start;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
@@ -0,0 +1,71 @@
+#pragma once
+#include <vector>
+#include "Vector3.hpp"
+#include "Matrix4.hpp"
+
+// Node of a transform hierarchy. The local transform is translation * rotation
+// * scale (Euler rotation applied Z, Y, X, as before) relative to the parent;
+// the world matrix is parent world * local.
+//
+// Both matrices are cached. Changing a node marks it and its subtree dirty, and
+// the matrices are rebuilt on the next access, so only changed subtrees are
+// recomputed. The lazy update makes const access non-thread-safe.
+//
+// Nodes refer to each other by address. Moving a node keeps its place in the
+// hierarchy (std::vector can relocate them safely); a copy joins the same
+// parent but takes no children. Destroying a node detaches its children,
+// which become roots.
+class Transform {
+public:
+    Transform();
+    ~Transform();
+
+    Transform(const Transform& other);
+    Transform& operator=(const Transform& other);
+    Transform(Transform&& other) noexcept;
+    Transform& operator=(Transform&& other) noexcept;
+
+    // Local properties (setting an unchanged value does not dirty the node)
+    void setPosition(const Vector3& newPosition);
+    void setRotation(const Vector3& newRotation);
+    void setScale(const Vector3& newScale);
+    const Vector3& getPosition() const { return position; }
+    const Vector3& getRotation() const { return rotation; }
+    const Vector3& getScale() const { return scale; }
+
+    // Hierarchy (null parent makes this a root). Reparenting keeps the local
+    // transform, so the node moves with its new parent. Returns false (and
+    // changes nothing) if newParent is this node or one of its descendants.
+    bool setParent(Transform* newParent);
+    Transform* getParent() const { return parent; }
+    const std::vector<Transform*>& getChildren() const { return children; }
+
+    // Cached matrices, rebuilt on access when dirty
+    const Matrix4& getLocalMatrix() const;
+    const Matrix4& getWorldMatrix() const;
+
+    // Changes whenever the world matrix changes (brings it up to date first)
+    unsigned int getWorldVersion() const;
+
+    // Object to world space
+    Vector3 transformPoint(const Vector3& point) const { return getWorldMatrix().multiply(point); }
+
+private:
+    void markLocalDirty();
+    void markWorldDirty();
+    void detachFromParent();
+    void replaceInHierarchy(Transform& other);
+
+    Vector3 position;
+    Vector3 rotation;   // Euler angles: X, Y, Z
+    Vector3 scale;
+
+    Transform* parent;
+    std::vector<Transform*> children;
+
+    mutable Matrix4 localMatrix;
+    mutable Matrix4 worldMatrix;
+    mutable bool localDirty;
+    mutable bool worldDirty;    // Invariant: a dirty node's descendants are all dirty
+    mutable unsigned int worldVersion;
+};
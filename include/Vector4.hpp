@@ -0,0 +1,18 @@
+#pragma once
+#include "Vector3.hpp"
+
+// Homogeneous coordinate (clip space positions keep their w)
+class Vector4 {
+public:
+    float x, y, z, w;
+
+    Vector4(float x = 0, float y = 0, float z = 0, float w = 1);
+    Vector4(const Vector3& v, float w);
+
+    Vector4 operator+(const Vector4& other) const;
+    Vector4 operator-(const Vector4& other) const;
+    Vector4 operator*(float scalar) const;
+
+    // Perspective divide (x/w, y/w, z/w)
+    Vector3 projected() const;
+};
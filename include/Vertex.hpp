@@ -4,6 +4,9 @@
 class Vertex {
 public:
     Vector3 position;
-    // Optional: color, normal, uv
+    Vector3 normal;     // Zero when the source has no normals
+    float u, v;         // Texture coordinates (zero when absent)
+    // Optional: color
     Vertex(const Vector3& pos = Vector3());
+    Vertex(const Vector3& pos, const Vector3& normal, float u, float v);
 };
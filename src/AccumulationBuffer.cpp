@@ -0,0 +1,106 @@
+#include "AccumulationBuffer.hpp"
+#include <algorithm>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+AccumulationBuffer::AccumulationBuffer(int width, int height)
+    : width(width), height(height),
+      red(getPixelCount(), 0.0f), green(getPixelCount(), 0.0f), blue(getPixelCount(), 0.0f),
+      toneMapping(ToneMapping::Clamp), invWhitePointSquared(0.25f) {}
+
+void AccumulationBuffer::clear(const LinearColor& color) {
+    std::fill(red.begin(), red.end(), color.r);
+    std::fill(green.begin(), green.end(), color.g);
+    std::fill(blue.begin(), blue.end(), color.b);
+}
+
+void AccumulationBuffer::setToneMapping(ToneMapping mode, float whitePoint) {
+    toneMapping = mode;
+    invWhitePointSquared = 1.0f / (whitePoint * whitePoint);
+}
+
+void AccumulationBuffer::resolve(std::uint32_t* out, size_t first, size_t count) const {
+    const float* r = red.data();
+    const float* g = green.data();
+    const float* b = blue.data();
+    const bool reinhard = toneMapping == ToneMapping::Reinhard;
+    const unsigned char* encode = LinearColor::getSRGBEncodeTable();
+    const float tableScale = static_cast<float>(LinearColor::SRGB_ENCODE_TABLE_SIZE - 1);
+    size_t i = first;
+    size_t end = first + count;
+
+    // Clamp below, tone map, clamp above, then round to the nearest entry of the
+    // sRGB encode table. The SIMD paths compute the table indices and look the
+    // bytes up one by one.
+    auto pack = [encode](std::uint32_t r, std::uint32_t g, std::uint32_t b) {
+        return encode[r] | (static_cast<std::uint32_t>(encode[g]) << 8) |
+               (static_cast<std::uint32_t>(encode[b]) << 16) | 0xFF000000u;
+    };
+#if defined(__AVX2__)
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 scale = _mm256_set1_ps(tableScale);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 invWhite = _mm256_set1_ps(invWhitePointSquared);
+
+    auto toIndex = [&](__m256 value) {
+        value = _mm256_max_ps(value, zero);
+        if (reinhard) {
+            value = _mm256_div_ps(_mm256_mul_ps(value, _mm256_add_ps(one, _mm256_mul_ps(value, invWhite))),
+                                  _mm256_add_ps(one, value));
+        }
+        value = _mm256_min_ps(value, one);
+        return _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(value, scale), half));
+    };
+
+    alignas(32) std::uint32_t rIndex[8], gIndex[8], bIndex[8];
+    for (; i + 8 <= end; i += 8) {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(rIndex), toIndex(_mm256_loadu_ps(r + i)));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(gIndex), toIndex(_mm256_loadu_ps(g + i)));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(bIndex), toIndex(_mm256_loadu_ps(b + i)));
+        for (int k = 0; k < 8; ++k) {
+            out[i + k] = pack(rIndex[k], gIndex[k], bIndex[k]);
+        }
+    }
+#elif defined(__SSE2__)
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps(tableScale);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 invWhite = _mm_set1_ps(invWhitePointSquared);
+
+    auto toIndex = [&](__m128 value) {
+        value = _mm_max_ps(value, zero);
+        if (reinhard) {
+            value = _mm_div_ps(_mm_mul_ps(value, _mm_add_ps(one, _mm_mul_ps(value, invWhite))),
+                               _mm_add_ps(one, value));
+        }
+        value = _mm_min_ps(value, one);
+        return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(value, scale), half));
+    };
+
+    alignas(16) std::uint32_t rIndex[4], gIndex[4], bIndex[4];
+    for (; i + 4 <= end; i += 4) {
+        _mm_store_si128(reinterpret_cast<__m128i*>(rIndex), toIndex(_mm_loadu_ps(r + i)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(gIndex), toIndex(_mm_loadu_ps(g + i)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(bIndex), toIndex(_mm_loadu_ps(b + i)));
+        for (int k = 0; k < 4; ++k) {
+            out[i + k] = pack(rIndex[k], gIndex[k], bIndex[k]);
+        }
+    }
+#endif
+
+    // Scalar tail
+    auto toIndexScalar = [&](float value) {
+        value = value > 0.0f ? value : 0.0f;    // NaN to 0 and infinity to 1, like the SIMD max and min
+        if (reinhard) {
+            value = value * (1.0f + value * invWhitePointSquared) / (1.0f + value);
+        }
+        value = value < 1.0f ? value : 1.0f;
+        return static_cast<std::uint32_t>(value * tableScale + 0.5f);
+    };
+    for (; i < end; ++i) {
+        out[i] = pack(toIndexScalar(r[i]), toIndexScalar(g[i]), toIndexScalar(b[i]));
+    }
+}
@@ -0,0 +1,94 @@
+#include "Bounds.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+AABB::AABB() : min(FLT_MAX, FLT_MAX, FLT_MAX), max(-FLT_MAX, -FLT_MAX, -FLT_MAX) {}
+
+AABB::AABB(const Vector3& min, const Vector3& max) : min(min), max(max) {}
+
+void AABB::expand(const Vector3& point) {
+    min.x = std::min(min.x, point.x);
+    min.y = std::min(min.y, point.y);
+    min.z = std::min(min.z, point.z);
+    max.x = std::max(max.x, point.x);
+    max.y = std::max(max.y, point.y);
+    max.z = std::max(max.z, point.z);
+}
+
+void AABB::expand(const AABB& other) {
+    if (other.isEmpty()) return;
+    expand(other.min);
+    expand(other.max);
+}
+
+Vector3 AABB::getCenter() const {
+    return (min + max) * 0.5f;
+}
+
+Vector3 AABB::getExtents() const {
+    return (max - min) * 0.5f;
+}
+
+AABB AABB::transformed(const Matrix4& matrix) const {
+    if (isEmpty()) return AABB();
+
+    // Transform the center, then project the extents onto each output axis
+    // using the absolute matrix entries (Arvo's method)
+    Vector3 center = getCenter();
+    Vector3 extents = getExtents();
+    const float c[3] = { center.x, center.y, center.z };
+    const float e[3] = { extents.x, extents.y, extents.z };
+
+    float newCenter[3];
+    float newExtents[3];
+    for (int row = 0; row < 3; ++row) {
+        newCenter[row] = matrix.m[row][3];
+        newExtents[row] = 0.0f;
+        for (int col = 0; col < 3; ++col) {
+            newCenter[row] += matrix.m[row][col] * c[col];
+            newExtents[row] += std::fabs(matrix.m[row][col]) * e[col];
+        }
+    }
+
+    Vector3 outCenter(newCenter[0], newCenter[1], newCenter[2]);
+    Vector3 outExtents(newExtents[0], newExtents[1], newExtents[2]);
+    return AABB(outCenter - outExtents, outCenter + outExtents);
+}
+
+BoundingSphere::BoundingSphere() : center(0, 0, 0), radius(-1.0f) {}
+
+BoundingSphere::BoundingSphere(const Vector3& center, float radius) : center(center), radius(radius) {}
+
+void BoundingSphere::expand(const Vector3& point) {
+    if (isEmpty()) {
+        center = point;
+        radius = 0.0f;
+        return;
+    }
+
+    Vector3 offset = point - center;
+    float distance = offset.length();
+    if (distance <= radius) return;
+
+    // Move the center towards the point so the new sphere touches both
+    // the far side of the old sphere and the point
+    float newRadius = (radius + distance) * 0.5f;
+    center = center + offset * ((newRadius - radius) / distance);
+    radius = newRadius;
+}
+
+BoundingSphere BoundingSphere::transformed(const Matrix4& matrix) const {
+    if (isEmpty()) return BoundingSphere();
+
+    // Largest column length of the upper 3x3 is the largest axis scale
+    float maxScaleSq = 0.0f;
+    for (int col = 0; col < 3; ++col) {
+        float lengthSq = matrix.m[0][col] * matrix.m[0][col] +
+                         matrix.m[1][col] * matrix.m[1][col] +
+                         matrix.m[2][col] * matrix.m[2][col];
+        maxScaleSq = std::max(maxScaleSq, lengthSq);
+    }
+
+    return BoundingSphere(matrix.multiply(center), radius * std::sqrt(maxScaleSq));
+}
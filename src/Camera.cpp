@@ -68,6 +68,10 @@ Matrix4 Camera::getViewProjectionMatrix() const {
     return getProjectionMatrix() * getViewMatrix();
 }
 
+Frustum Camera::getFrustum() const {
+    return Frustum(getViewProjectionMatrix());
+}
+
 void Camera::setPerspective(float fov, float aspect, float near, float far) {
     fieldOfView = fov;
     aspectRatio = aspect;
@@ -3,22 +3,24 @@
 // Constructor definition
 Color::Color(unsigned char red, unsigned char green, unsigned char blue)
     : r(red), g(green), b(blue) {}
+static unsigned char clampChannel(int value) {
+    if (value < 0) return 0;
+    if (value > 255) return 255;
+    return static_cast<unsigned char>(value);
+}
+
 // Multiply color by a float (0.0 - 1.0)
 Color Color::operator*(float factor) const {
-    auto clamp = [](int value) -> unsigned char {
-        if (value < 0) return 0;
-        if (value > 255) return 255;
-        return static_cast<unsigned char>(value);
-    };
     return Color(
-        clamp(static_cast<int>(r * factor)),
-        clamp(static_cast<int>(g * factor)),
-        clamp(static_cast<int>(b * factor))
+        clampChannel(static_cast<int>(r * factor)),
+        clampChannel(static_cast<int>(g * factor)),
+        clampChannel(static_cast<int>(b * factor))
     );
 }
 
+// Saturating add (the channels would otherwise wrap around)
 Color Color::operator+(const Color& other) const {
   return Color(
-    r+other.r, g+other.g, b+other.b
+    clampChannel(r + other.r), clampChannel(g + other.g), clampChannel(b + other.b)
   );
 }
@@ -0,0 +1,112 @@
+#include "FramePipeline.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+
+FramePipeline::FramePipeline(Renderer& renderer, size_t bufferCount)
+    : renderer(renderer), slots(std::max<size_t>(bufferCount, 1)), nextFrameNumber(0), stopping(false)
+{
+    renderThread = std::thread(&FramePipeline::renderLoop, this);
+}
+
+FramePipeline::~FramePipeline() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        renderQueue.clear();
+    }
+    frameQueued.notify_one();
+
+    // A frame being rendered is finished first
+    renderThread.join();
+}
+
+const FramePipeline::Frame* FramePipeline::submit(FrameFunction function) {
+    std::unique_lock<std::mutex> lock(mutex);
+    releaseReturnedFrame();
+
+    // At most bufferCount - 1 frames are unreleased here, so a slot is free
+    size_t index = 0;
+    while (slots[index].state != SlotState::Free) ++index;
+
+    Slot& slot = slots[index];
+    slot.state = SlotState::Queued;
+    slot.function = std::move(function);
+    slot.frame.number = nextFrameNumber++;
+    slot.submitTime = Clock::now();
+    renderQueue.push_back(index);
+    presentQueue.push_back(index);
+    frameQueued.notify_one();
+
+    if (presentQueue.size() < slots.size()) return nullptr;
+    return waitForOldest(lock);
+}
+
+const FramePipeline::Frame* FramePipeline::finish() {
+    std::unique_lock<std::mutex> lock(mutex);
+    releaseReturnedFrame();
+    if (presentQueue.empty()) return nullptr;
+    return waitForOldest(lock);
+}
+
+void FramePipeline::releaseReturnedFrame() {
+    if (presentQueue.empty()) return;
+    Slot& slot = slots[presentQueue.front()];
+    if (slot.state != SlotState::Acquired) return;
+
+    ++stats.frames;
+    stats.renderMs += slot.renderMs;
+    stats.latencyMs += std::chrono::duration<double, std::milli>(Clock::now() - slot.submitTime).count();
+    slot.state = SlotState::Free;
+    presentQueue.pop_front();
+}
+
+const FramePipeline::Frame* FramePipeline::waitForOldest(std::unique_lock<std::mutex>& lock) {
+    Slot& slot = slots[presentQueue.front()];
+    if (slot.state != SlotState::Rendered) {
+        TRACE_SCOPE("FramePipeline::wait");
+        Clock::time_point start = Clock::now();
+        frameRendered.wait(lock, [&slot] { return slot.state == SlotState::Rendered; });
+        stats.stallMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+    slot.state = SlotState::Acquired;
+    return &slot.frame;
+}
+
+FramePipeline::Stats FramePipeline::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+void FramePipeline::renderLoop() {
+    Trace::setThreadName("Render");
+    while (true) {
+        size_t index;
+        FrameFunction function;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            frameQueued.wait(lock, [this] { return stopping || !renderQueue.empty(); });
+            if (stopping) return;
+            index = renderQueue.front();
+            renderQueue.pop_front();
+            function = std::move(slots[index].function);
+        }
+
+        // Queued slots are only touched by this thread
+        Slot& slot = slots[index];
+        Clock::time_point start = Clock::now();
+        {
+            TRACE_SCOPE("FramePipeline::frame");
+            function(renderer);
+            renderer.resolve(slot.frame.pixels);
+        }
+        slot.frame.stats = renderer.getFrameStats();
+        double renderMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            slot.renderMs = renderMs;
+            slot.state = SlotState::Rendered;
+        }
+        frameRendered.notify_one();
+    }
+}
@@ -0,0 +1,16 @@
+#include "FrameStats.hpp"
+
+void FrameStats::writeCSVHeader(std::ostream& out) {
+    out << "frame,triangles_submitted,triangles_drawn,culled_behind_camera,culled_off_screen,"
+           "culled_back_face,culled_degenerate,pixels_tested,pixels_passed,overdraw,"
+           "lighting_evaluations,clear_ms,transform_ms,lighting_ms,raster_ms,present_ms\n";
+}
+
+void FrameStats::writeCSVRow(std::ostream& out) const {
+    out << frame << ',' << trianglesSubmitted << ',' << getTrianglesDrawn() << ','
+        << trianglesBehindCamera << ',' << trianglesOffScreen << ','
+        << trianglesBackFacing << ',' << trianglesDegenerate << ','
+        << pixelsTested << ',' << pixelsPassed << ',' << getOverdraw() << ','
+        << lightingEvaluations << ',' << clearMs << ',' << transformMs << ','
+        << lightingMs << ',' << rasterMs << ',' << presentMs << '\n';
+}
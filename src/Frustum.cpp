@@ -0,0 +1,68 @@
+#include "Frustum.hpp"
+
+Plane::Plane() : normal(0, 0, 0), distance(0.0f) {}
+
+Plane::Plane(const Vector3& normal, float distance) : normal(normal), distance(distance) {}
+
+void Plane::normalize() {
+    float length = normal.length();
+    if (length > 0.0f) {
+        normal = normal / length;
+        distance /= length;
+    }
+}
+
+Frustum::Frustum() {}
+
+Frustum::Frustum(const Matrix4& viewProjection) {
+    const float (*m)[4] = viewProjection.m;
+
+    // A point is inside when -w <= x, y, z <= w in clip space; each inequality
+    // is a plane built from the w row plus or minus one of the other rows
+    auto makePlane = [&](int row, float sign) {
+        Plane plane(Vector3(m[3][0] + sign * m[row][0],
+                            m[3][1] + sign * m[row][1],
+                            m[3][2] + sign * m[row][2]),
+                    m[3][3] + sign * m[row][3]);
+        plane.normalize();
+        return plane;
+    };
+
+    planes[PLANE_LEFT]   = makePlane(0, 1.0f);
+    planes[PLANE_RIGHT]  = makePlane(0, -1.0f);
+    planes[PLANE_BOTTOM] = makePlane(1, 1.0f);
+    planes[PLANE_TOP]    = makePlane(1, -1.0f);
+    planes[PLANE_NEAR]   = makePlane(2, 1.0f);
+    planes[PLANE_FAR]    = makePlane(2, -1.0f);
+}
+
+Frustum::TestResult Frustum::testSphere(const BoundingSphere& sphere) const {
+    if (sphere.isEmpty()) return OUTSIDE;
+
+    TestResult result = INSIDE;
+    for (const Plane& plane : planes) {
+        float distance = plane.distanceTo(sphere.center);
+        if (distance < -sphere.radius) return OUTSIDE;
+        if (distance < sphere.radius) result = INTERSECTS;
+    }
+    return result;
+}
+
+Frustum::TestResult Frustum::testAABB(const AABB& box) const {
+    if (box.isEmpty()) return OUTSIDE;
+
+    TestResult result = INSIDE;
+    for (const Plane& plane : planes) {
+        // Corner furthest along the plane normal, and the one opposite it
+        Vector3 positive(plane.normal.x >= 0.0f ? box.max.x : box.min.x,
+                         plane.normal.y >= 0.0f ? box.max.y : box.min.y,
+                         plane.normal.z >= 0.0f ? box.max.z : box.min.z);
+        Vector3 negative(plane.normal.x >= 0.0f ? box.min.x : box.max.x,
+                         plane.normal.y >= 0.0f ? box.min.y : box.max.y,
+                         plane.normal.z >= 0.0f ? box.min.z : box.max.z);
+
+        if (plane.distanceTo(positive) < 0.0f) return OUTSIDE;
+        if (plane.distanceTo(negative) < 0.0f) result = INTERSECTS;
+    }
+    return result;
+}
@@ -0,0 +1,211 @@
+#include "LightingEngine.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+#include <cmath>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+LightingEngine::LightingEngine()
+    : ambientR(0.0f), ambientG(0.0f), ambientB(0.0f), viewPos(0, 0, 0), tableShininess(0.0f) {
+    buildSpecularTable(tableShininess);
+}
+
+void LightingEngine::prepare(const std::vector<Light>& lights, const Material& material, const Vector3& newViewPos) {
+    viewPos = newViewPos;
+    ambientR = ambientG = ambientB = 0.0f;
+    preparedLights.clear();
+
+    for (const Light& light : lights) {
+        LinearColor ambient = LinearColor(light.ambient) * material.kAmbient;
+        LinearColor diffuse = LinearColor(light.diffuse) * material.kDiffuse;
+        LinearColor specular = LinearColor(light.specular) * material.kSpecular;
+        ambientR += ambient.r;
+        ambientG += ambient.g;
+        ambientB += ambient.b;
+
+        Vector3 direction = light.direction.normalized();
+        PreparedLight prepared;
+        prepared.dirX = direction.x;
+        prepared.dirY = direction.y;
+        prepared.dirZ = direction.z;
+        prepared.diffuseR = diffuse.r;
+        prepared.diffuseG = diffuse.g;
+        prepared.diffuseB = diffuse.b;
+        prepared.specularR = specular.r;
+        prepared.specularG = specular.g;
+        prepared.specularB = specular.b;
+        preparedLights.push_back(prepared);
+    }
+
+    if (material.shininess != tableShininess) {
+        buildSpecularTable(material.shininess);
+    }
+}
+
+void LightingEngine::buildSpecularTable(float exponent) {
+    specularTable.resize(SPECULAR_TABLE_SIZE + 1);
+    for (size_t i = 0; i <= SPECULAR_TABLE_SIZE; ++i) {
+        specularTable[i] = std::pow(static_cast<float>(i) / SPECULAR_TABLE_SIZE, exponent);
+    }
+    tableShininess = exponent;
+}
+
+float LightingEngine::specularPower(float x) const {
+    // x is max(R.V, 0); rounding can take it slightly past 1
+    float t = std::min(x, 1.0f) * SPECULAR_TABLE_SIZE;
+    size_t index = std::min(static_cast<size_t>(t), SPECULAR_TABLE_SIZE - 1);
+    float a = specularTable[index];
+    float b = specularTable[index + 1];
+    return a + (b - a) * (t - static_cast<float>(index));
+}
+
+LinearColor LightingEngine::evaluate(const Vector3& position, const Vector3& normal) const {
+    // Normalized like the SIMD path (multiply by the reciprocal length)
+    Vector3 view = viewPos - position;
+    float length = view.length();
+    view = view * (length > 0.0f ? 1.0f / length : 0.0f);
+    float nDotV = normal.dot(view);
+    float r = ambientR, g = ambientG, b = ambientB;
+
+    for (const PreparedLight& light : preparedLights) {
+        float nDotL = normal.x * light.dirX + normal.y * light.dirY + normal.z * light.dirZ;
+        float lDotV = light.dirX * view.x + light.dirY * view.y + light.dirZ * view.z;
+
+        // Phong reflection: R = 2(N.L)N - L is unit length, so R.V = 2(N.L)(N.V) - L.V
+        float diffuse = std::max(nDotL, 0.0f);
+        float specular = specularPower(std::max(2.0f * nDotL * nDotV - lDotV, 0.0f));
+        r += light.diffuseR * diffuse + light.specularR * specular;
+        g += light.diffuseG * diffuse + light.specularG * specular;
+        b += light.diffuseB * diffuse + light.specularB * specular;
+    }
+
+    return LinearColor(r, g, b);
+}
+
+void LightingEngine::evaluate(const float* px, const float* py, const float* pz,
+                              const float* nx, const float* ny, const float* nz,
+                              size_t count, LinearColor* out) const {
+    TRACE_SCOPE("LightingEngine::evaluate");
+    size_t i = 0;
+
+#if defined(__AVX__)
+    const __m256 viewX = _mm256_set1_ps(viewPos.x), viewY = _mm256_set1_ps(viewPos.y), viewZ = _mm256_set1_ps(viewPos.z);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 two = _mm256_set1_ps(2.0f);
+#if defined(__AVX2__)
+    const __m256 tableScale = _mm256_set1_ps(static_cast<float>(SPECULAR_TABLE_SIZE));
+    const __m256i lastIndex = _mm256_set1_epi32(static_cast<int>(SPECULAR_TABLE_SIZE - 1));
+#else
+    alignas(32) float lanes[8];     // Specular table lookups without gathers
+#endif
+    alignas(32) float red[8], green[8], blue[8];
+
+    for (; i + 8 <= count; i += 8) {
+        __m256 vx = _mm256_sub_ps(viewX, _mm256_loadu_ps(px + i));
+        __m256 vy = _mm256_sub_ps(viewY, _mm256_loadu_ps(py + i));
+        __m256 vz = _mm256_sub_ps(viewZ, _mm256_loadu_ps(pz + i));
+        __m256 length = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)), _mm256_mul_ps(vz, vz)));
+        __m256 invLength = _mm256_and_ps(_mm256_cmp_ps(length, zero, _CMP_GT_OQ), _mm256_div_ps(one, length));
+        vx = _mm256_mul_ps(vx, invLength);
+        vy = _mm256_mul_ps(vy, invLength);
+        vz = _mm256_mul_ps(vz, invLength);
+
+        __m256 normalX = _mm256_loadu_ps(nx + i);
+        __m256 normalY = _mm256_loadu_ps(ny + i);
+        __m256 normalZ = _mm256_loadu_ps(nz + i);
+        __m256 nDotV = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(normalX, vx), _mm256_mul_ps(normalY, vy)), _mm256_mul_ps(normalZ, vz));
+
+        __m256 r = _mm256_set1_ps(ambientR);
+        __m256 g = _mm256_set1_ps(ambientG);
+        __m256 b = _mm256_set1_ps(ambientB);
+
+        for (const PreparedLight& light : preparedLights) {
+            const __m256 dirX = _mm256_set1_ps(light.dirX), dirY = _mm256_set1_ps(light.dirY), dirZ = _mm256_set1_ps(light.dirZ);
+            __m256 nDotL = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(normalX, dirX), _mm256_mul_ps(normalY, dirY)), _mm256_mul_ps(normalZ, dirZ));
+            __m256 lDotV = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dirX, vx), _mm256_mul_ps(dirY, vy)), _mm256_mul_ps(dirZ, vz));
+            __m256 diffuse = _mm256_max_ps(nDotL, zero);
+            __m256 rDotV = _mm256_max_ps(_mm256_sub_ps(_mm256_mul_ps(_mm256_mul_ps(two, nDotL), nDotV), lDotV), zero);
+
+#if defined(__AVX2__)
+            __m256 t = _mm256_mul_ps(_mm256_min_ps(rDotV, one), tableScale);
+            __m256i index = _mm256_min_epi32(_mm256_cvttps_epi32(t), lastIndex);
+            __m256 a = _mm256_i32gather_ps(specularTable.data(), index, 4);
+            __m256 next = _mm256_i32gather_ps(specularTable.data() + 1, index, 4);
+            __m256 specular = _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(next, a), _mm256_sub_ps(t, _mm256_cvtepi32_ps(index))));
+#else
+            _mm256_store_ps(lanes, rDotV);
+            for (int k = 0; k < 8; ++k) lanes[k] = specularPower(lanes[k]);
+            __m256 specular = _mm256_load_ps(lanes);
+#endif
+
+            r = _mm256_add_ps(r, _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(light.diffuseR), diffuse), _mm256_mul_ps(_mm256_set1_ps(light.specularR), specular)));
+            g = _mm256_add_ps(g, _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(light.diffuseG), diffuse), _mm256_mul_ps(_mm256_set1_ps(light.specularG), specular)));
+            b = _mm256_add_ps(b, _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(light.diffuseB), diffuse), _mm256_mul_ps(_mm256_set1_ps(light.specularB), specular)));
+        }
+
+        _mm256_store_ps(red, r);
+        _mm256_store_ps(green, g);
+        _mm256_store_ps(blue, b);
+        for (int k = 0; k < 8; ++k) {
+            out[i + k] = LinearColor(red[k], green[k], blue[k]);
+        }
+    }
+#elif defined(__SSE2__)
+    const __m128 viewX = _mm_set1_ps(viewPos.x), viewY = _mm_set1_ps(viewPos.y), viewZ = _mm_set1_ps(viewPos.z);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+    alignas(16) float lanes[4];
+    alignas(16) float red[4], green[4], blue[4];
+
+    for (; i + 4 <= count; i += 4) {
+        __m128 vx = _mm_sub_ps(viewX, _mm_loadu_ps(px + i));
+        __m128 vy = _mm_sub_ps(viewY, _mm_loadu_ps(py + i));
+        __m128 vz = _mm_sub_ps(viewZ, _mm_loadu_ps(pz + i));
+        __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz)));
+        __m128 invLength = _mm_and_ps(_mm_cmpgt_ps(length, zero), _mm_div_ps(one, length));
+        vx = _mm_mul_ps(vx, invLength);
+        vy = _mm_mul_ps(vy, invLength);
+        vz = _mm_mul_ps(vz, invLength);
+
+        __m128 normalX = _mm_loadu_ps(nx + i);
+        __m128 normalY = _mm_loadu_ps(ny + i);
+        __m128 normalZ = _mm_loadu_ps(nz + i);
+        __m128 nDotV = _mm_add_ps(_mm_add_ps(_mm_mul_ps(normalX, vx), _mm_mul_ps(normalY, vy)), _mm_mul_ps(normalZ, vz));
+
+        __m128 r = _mm_set1_ps(ambientR);
+        __m128 g = _mm_set1_ps(ambientG);
+        __m128 b = _mm_set1_ps(ambientB);
+
+        for (const PreparedLight& light : preparedLights) {
+            const __m128 dirX = _mm_set1_ps(light.dirX), dirY = _mm_set1_ps(light.dirY), dirZ = _mm_set1_ps(light.dirZ);
+            __m128 nDotL = _mm_add_ps(_mm_add_ps(_mm_mul_ps(normalX, dirX), _mm_mul_ps(normalY, dirY)), _mm_mul_ps(normalZ, dirZ));
+            __m128 lDotV = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dirX, vx), _mm_mul_ps(dirY, vy)), _mm_mul_ps(dirZ, vz));
+            __m128 diffuse = _mm_max_ps(nDotL, zero);
+            __m128 rDotV = _mm_max_ps(_mm_sub_ps(_mm_mul_ps(_mm_mul_ps(two, nDotL), nDotV), lDotV), zero);
+
+            _mm_store_ps(lanes, rDotV);
+            for (int k = 0; k < 4; ++k) lanes[k] = specularPower(lanes[k]);
+            __m128 specular = _mm_load_ps(lanes);
+
+            r = _mm_add_ps(r, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(light.diffuseR), diffuse), _mm_mul_ps(_mm_set1_ps(light.specularR), specular)));
+            g = _mm_add_ps(g, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(light.diffuseG), diffuse), _mm_mul_ps(_mm_set1_ps(light.specularG), specular)));
+            b = _mm_add_ps(b, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(light.diffuseB), diffuse), _mm_mul_ps(_mm_set1_ps(light.specularB), specular)));
+        }
+
+        _mm_store_ps(red, r);
+        _mm_store_ps(green, g);
+        _mm_store_ps(blue, b);
+        for (int k = 0; k < 4; ++k) {
+            out[i + k] = LinearColor(red[k], green[k], blue[k]);
+        }
+    }
+#endif
+
+    // Scalar tail
+    for (; i < count; ++i) {
+        out[i] = evaluate(Vector3(px[i], py[i], pz[i]), Vector3(nx[i], ny[i], nz[i]));
+    }
+}
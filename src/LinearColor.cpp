@@ -0,0 +1,56 @@
+#include "LinearColor.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+struct SRGBTables {
+    float decode[256];
+    unsigned char encode[LinearColor::SRGB_ENCODE_TABLE_SIZE];
+
+    SRGBTables() {
+        for (int i = 0; i < 256; ++i) {
+            float value = i / 255.0f;
+            decode[i] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+        }
+        for (int i = 0; i < LinearColor::SRGB_ENCODE_TABLE_SIZE; ++i) {
+            float value = static_cast<float>(i) / (LinearColor::SRGB_ENCODE_TABLE_SIZE - 1);
+            float encoded = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+            encode[i] = static_cast<unsigned char>(std::min(std::max(encoded, 0.0f), 1.0f) * 255.0f + 0.5f);
+        }
+    }
+};
+
+const SRGBTables& getSRGBTables() {
+    static const SRGBTables tables;
+    return tables;
+}
+
+} // namespace
+
+LinearColor::LinearColor(float red, float green, float blue)
+    : r(red), g(green), b(blue) {}
+
+LinearColor::LinearColor(const Color& color)
+    : r(decodeSRGB(color.r)), g(decodeSRGB(color.g)), b(decodeSRGB(color.b)) {}
+
+LinearColor LinearColor::operator+(const LinearColor& other) const {
+    return LinearColor(r + other.r, g + other.g, b + other.b);
+}
+
+LinearColor LinearColor::operator*(float factor) const {
+    return LinearColor(r * factor, g * factor, b * factor);
+}
+
+const float* LinearColor::getSRGBDecodeTable() {
+    return getSRGBTables().decode;
+}
+
+const unsigned char* LinearColor::getSRGBEncodeTable() {
+    return getSRGBTables().encode;
+}
+
+unsigned char LinearColor::encodeSRGB(float value) {
+    value = std::min(std::max(value, 0.0f), 1.0f);
+    return getSRGBEncodeTable()[static_cast<int>(value * (SRGB_ENCODE_TABLE_SIZE - 1) + 0.5f)];
+}
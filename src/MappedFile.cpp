@@ -0,0 +1,84 @@
+#include "MappedFile.hpp"
+#include <cstdlib>
+
+#if defined(_WIN32)
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() : bytes(nullptr), length(0) {}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+#if defined(_WIN32)
+
+bool MappedFile::open(const std::string& filename) {
+    close();
+
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return false;
+
+    std::streamsize fileSize = file.tellg();
+    if (fileSize <= 0) return false;
+    file.seekg(0);
+
+    // Page-sized alignment keeps the same guarantees as a real mapping
+    size_t allocation = (static_cast<size_t>(fileSize) + 4095) / 4096 * 4096;
+    unsigned char* buffer = static_cast<unsigned char*>(_aligned_malloc(allocation, 4096));
+    if (!buffer) return false;
+    if (!file.read(reinterpret_cast<char*>(buffer), fileSize)) {
+        _aligned_free(buffer);
+        return false;
+    }
+
+    bytes = buffer;
+    length = static_cast<size_t>(fileSize);
+    return true;
+}
+
+void MappedFile::close() {
+    if (bytes) {
+        _aligned_free(const_cast<unsigned char*>(bytes));
+    }
+    bytes = nullptr;
+    length = 0;
+}
+
+#else
+
+bool MappedFile::open(const std::string& filename) {
+    close();
+
+    int descriptor = ::open(filename.c_str(), O_RDONLY);
+    if (descriptor < 0) return false;
+
+    struct stat info;
+    if (fstat(descriptor, &info) != 0 || info.st_size <= 0) {
+        ::close(descriptor);
+        return false;
+    }
+
+    void* mapping = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor); // The mapping keeps its own reference to the file
+    if (mapping == MAP_FAILED) return false;
+
+    bytes = static_cast<const unsigned char*>(mapping);
+    length = static_cast<size_t>(info.st_size);
+    return true;
+}
+
+void MappedFile::close() {
+    if (bytes) {
+        munmap(const_cast<unsigned char*>(bytes), length);
+    }
+    bytes = nullptr;
+    length = 0;
+}
+
+#endif
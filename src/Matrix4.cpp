@@ -1,5 +1,8 @@
 #include "Matrix4.hpp"
 #include <cmath>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 Matrix4::Matrix4() {
     // Initialize to identity matrix
@@ -115,6 +118,128 @@ Vector3 Matrix4::multiply(const Vector3& v) const {
     return Vector3(x, y, z);
 }
 
+Vector4 Matrix4::multiplyHomogeneous(const Vector3& v) const {
+    float x = m[0][0] * v.x + m[0][1] * v.y + m[0][2] * v.z + m[0][3];
+    float y = m[1][0] * v.x + m[1][1] * v.y + m[1][2] * v.z + m[1][3];
+    float z = m[2][0] * v.x + m[2][1] * v.y + m[2][2] * v.z + m[2][3];
+    float w = m[3][0] * v.x + m[3][1] * v.y + m[3][2] * v.z + m[3][3];
+    return Vector4(x, y, z, w);
+}
+
+void Matrix4::transformPoints(const float* inX, const float* inY, const float* inZ,
+                              float* outX, float* outY, float* outZ, size_t count) const {
+    size_t i = 0;
+    
+#if defined(__AVX__)
+    const __m256 m00 = _mm256_set1_ps(m[0][0]), m01 = _mm256_set1_ps(m[0][1]), m02 = _mm256_set1_ps(m[0][2]), m03 = _mm256_set1_ps(m[0][3]);
+    const __m256 m10 = _mm256_set1_ps(m[1][0]), m11 = _mm256_set1_ps(m[1][1]), m12 = _mm256_set1_ps(m[1][2]), m13 = _mm256_set1_ps(m[1][3]);
+    const __m256 m20 = _mm256_set1_ps(m[2][0]), m21 = _mm256_set1_ps(m[2][1]), m22 = _mm256_set1_ps(m[2][2]), m23 = _mm256_set1_ps(m[2][3]);
+    const __m256 m30 = _mm256_set1_ps(m[3][0]), m31 = _mm256_set1_ps(m[3][1]), m32 = _mm256_set1_ps(m[3][2]), m33 = _mm256_set1_ps(m[3][3]);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    
+    for (; i + 8 <= count; i += 8) {
+        __m256 vx = _mm256_loadu_ps(inX + i);
+        __m256 vy = _mm256_loadu_ps(inY + i);
+        __m256 vz = _mm256_loadu_ps(inZ + i);
+        
+        // Same operation order as multiply(), so results match it exactly
+        __m256 x = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m00, vx), _mm256_mul_ps(m01, vy)), _mm256_mul_ps(m02, vz)), m03);
+        __m256 y = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m10, vx), _mm256_mul_ps(m11, vy)), _mm256_mul_ps(m12, vz)), m13);
+        __m256 z = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m20, vx), _mm256_mul_ps(m21, vy)), _mm256_mul_ps(m22, vz)), m23);
+        __m256 w = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m30, vx), _mm256_mul_ps(m31, vy)), _mm256_mul_ps(m32, vz)), m33);
+        
+        // Perspective divide only where w != 0 and w != 1
+        __m256 divide = _mm256_and_ps(_mm256_cmp_ps(w, zero, _CMP_NEQ_UQ), _mm256_cmp_ps(w, one, _CMP_NEQ_UQ));
+        _mm256_storeu_ps(outX + i, _mm256_blendv_ps(x, _mm256_div_ps(x, w), divide));
+        _mm256_storeu_ps(outY + i, _mm256_blendv_ps(y, _mm256_div_ps(y, w), divide));
+        _mm256_storeu_ps(outZ + i, _mm256_blendv_ps(z, _mm256_div_ps(z, w), divide));
+    }
+#elif defined(__SSE2__)
+    const __m128 m00 = _mm_set1_ps(m[0][0]), m01 = _mm_set1_ps(m[0][1]), m02 = _mm_set1_ps(m[0][2]), m03 = _mm_set1_ps(m[0][3]);
+    const __m128 m10 = _mm_set1_ps(m[1][0]), m11 = _mm_set1_ps(m[1][1]), m12 = _mm_set1_ps(m[1][2]), m13 = _mm_set1_ps(m[1][3]);
+    const __m128 m20 = _mm_set1_ps(m[2][0]), m21 = _mm_set1_ps(m[2][1]), m22 = _mm_set1_ps(m[2][2]), m23 = _mm_set1_ps(m[2][3]);
+    const __m128 m30 = _mm_set1_ps(m[3][0]), m31 = _mm_set1_ps(m[3][1]), m32 = _mm_set1_ps(m[3][2]), m33 = _mm_set1_ps(m[3][3]);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    
+    for (; i + 4 <= count; i += 4) {
+        __m128 vx = _mm_loadu_ps(inX + i);
+        __m128 vy = _mm_loadu_ps(inY + i);
+        __m128 vz = _mm_loadu_ps(inZ + i);
+        
+        // Same operation order as multiply(), so results match it exactly
+        __m128 x = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, vx), _mm_mul_ps(m01, vy)), _mm_mul_ps(m02, vz)), m03);
+        __m128 y = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m10, vx), _mm_mul_ps(m11, vy)), _mm_mul_ps(m12, vz)), m13);
+        __m128 z = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m20, vx), _mm_mul_ps(m21, vy)), _mm_mul_ps(m22, vz)), m23);
+        __m128 w = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m30, vx), _mm_mul_ps(m31, vy)), _mm_mul_ps(m32, vz)), m33);
+        
+        // Perspective divide only where w != 0 and w != 1
+        __m128 divide = _mm_and_ps(_mm_cmpneq_ps(w, zero), _mm_cmpneq_ps(w, one));
+        _mm_storeu_ps(outX + i, _mm_or_ps(_mm_and_ps(divide, _mm_div_ps(x, w)), _mm_andnot_ps(divide, x)));
+        _mm_storeu_ps(outY + i, _mm_or_ps(_mm_and_ps(divide, _mm_div_ps(y, w)), _mm_andnot_ps(divide, y)));
+        _mm_storeu_ps(outZ + i, _mm_or_ps(_mm_and_ps(divide, _mm_div_ps(z, w)), _mm_andnot_ps(divide, z)));
+    }
+#endif
+    
+    // Scalar tail
+    for (; i < count; ++i) {
+        Vector3 result = multiply(Vector3(inX[i], inY[i], inZ[i]));
+        outX[i] = result.x;
+        outY[i] = result.y;
+        outZ[i] = result.z;
+    }
+}
+
+void Matrix4::transformPointsHomogeneous(const float* inX, const float* inY, const float* inZ,
+                                         float* outX, float* outY, float* outZ, float* outW,
+                                         size_t count) const {
+    size_t i = 0;
+    
+#if defined(__AVX__)
+    const __m256 m00 = _mm256_set1_ps(m[0][0]), m01 = _mm256_set1_ps(m[0][1]), m02 = _mm256_set1_ps(m[0][2]), m03 = _mm256_set1_ps(m[0][3]);
+    const __m256 m10 = _mm256_set1_ps(m[1][0]), m11 = _mm256_set1_ps(m[1][1]), m12 = _mm256_set1_ps(m[1][2]), m13 = _mm256_set1_ps(m[1][3]);
+    const __m256 m20 = _mm256_set1_ps(m[2][0]), m21 = _mm256_set1_ps(m[2][1]), m22 = _mm256_set1_ps(m[2][2]), m23 = _mm256_set1_ps(m[2][3]);
+    const __m256 m30 = _mm256_set1_ps(m[3][0]), m31 = _mm256_set1_ps(m[3][1]), m32 = _mm256_set1_ps(m[3][2]), m33 = _mm256_set1_ps(m[3][3]);
+    
+    for (; i + 8 <= count; i += 8) {
+        __m256 vx = _mm256_loadu_ps(inX + i);
+        __m256 vy = _mm256_loadu_ps(inY + i);
+        __m256 vz = _mm256_loadu_ps(inZ + i);
+        
+        _mm256_storeu_ps(outX + i, _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m00, vx), _mm256_mul_ps(m01, vy)), _mm256_mul_ps(m02, vz)), m03));
+        _mm256_storeu_ps(outY + i, _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m10, vx), _mm256_mul_ps(m11, vy)), _mm256_mul_ps(m12, vz)), m13));
+        _mm256_storeu_ps(outZ + i, _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m20, vx), _mm256_mul_ps(m21, vy)), _mm256_mul_ps(m22, vz)), m23));
+        _mm256_storeu_ps(outW + i, _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m30, vx), _mm256_mul_ps(m31, vy)), _mm256_mul_ps(m32, vz)), m33));
+    }
+#elif defined(__SSE2__)
+    const __m128 m00 = _mm_set1_ps(m[0][0]), m01 = _mm_set1_ps(m[0][1]), m02 = _mm_set1_ps(m[0][2]), m03 = _mm_set1_ps(m[0][3]);
+    const __m128 m10 = _mm_set1_ps(m[1][0]), m11 = _mm_set1_ps(m[1][1]), m12 = _mm_set1_ps(m[1][2]), m13 = _mm_set1_ps(m[1][3]);
+    const __m128 m20 = _mm_set1_ps(m[2][0]), m21 = _mm_set1_ps(m[2][1]), m22 = _mm_set1_ps(m[2][2]), m23 = _mm_set1_ps(m[2][3]);
+    const __m128 m30 = _mm_set1_ps(m[3][0]), m31 = _mm_set1_ps(m[3][1]), m32 = _mm_set1_ps(m[3][2]), m33 = _mm_set1_ps(m[3][3]);
+    
+    for (; i + 4 <= count; i += 4) {
+        __m128 vx = _mm_loadu_ps(inX + i);
+        __m128 vy = _mm_loadu_ps(inY + i);
+        __m128 vz = _mm_loadu_ps(inZ + i);
+        
+        _mm_storeu_ps(outX + i, _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, vx), _mm_mul_ps(m01, vy)), _mm_mul_ps(m02, vz)), m03));
+        _mm_storeu_ps(outY + i, _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m10, vx), _mm_mul_ps(m11, vy)), _mm_mul_ps(m12, vz)), m13));
+        _mm_storeu_ps(outZ + i, _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m20, vx), _mm_mul_ps(m21, vy)), _mm_mul_ps(m22, vz)), m23));
+        _mm_storeu_ps(outW + i, _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m30, vx), _mm_mul_ps(m31, vy)), _mm_mul_ps(m32, vz)), m33));
+    }
+#endif
+    
+    // Scalar tail
+    for (; i < count; ++i) {
+        Vector4 result = multiplyHomogeneous(Vector3(inX[i], inY[i], inZ[i]));
+        outX[i] = result.x;
+        outY[i] = result.y;
+        outZ[i] = result.z;
+        outW[i] = result.w;
+    }
+}
+
 Matrix4 Matrix4::operator*(const Matrix4& other) const {
     Matrix4 result;
     
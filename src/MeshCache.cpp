@@ -0,0 +1,231 @@
+#include "MeshCache.hpp"
+#include "MappedFile.hpp"
+#include "Trace.hpp"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+static_assert(sizeof(MeshCacheHeader) == 144, "MeshCacheHeader layout changed");
+
+static const char MAGIC[8] = { 'M', 'E', 'S', 'H', 'B', 'I', 'N', '\0' };
+
+static uint64_t alignOffset(uint64_t offset) {
+    return (offset + MeshCache::BLOCK_ALIGNMENT - 1) / MeshCache::BLOCK_ALIGNMENT * MeshCache::BLOCK_ALIGNMENT;
+}
+
+// An aligned block of `bytes` bytes that lies after the header and inside the file
+static bool isBlockValid(const MeshCacheHeader& header, uint64_t offset, uint64_t bytes) {
+    return offset % MeshCache::BLOCK_ALIGNMENT == 0 && offset >= sizeof(MeshCacheHeader) &&
+           offset <= header.fileSize && bytes <= header.fileSize - offset;
+}
+
+// Scatter one vertex attribute into zero-padded SoA arrays of `padded` floats each
+template <int Components, typename Getter>
+static std::vector<float> makeStream(size_t count, size_t padded, Getter get) {
+    std::vector<float> stream(Components * padded, 0.0f);
+    float values[Components];
+    for (size_t i = 0; i < count; ++i) {
+        get(i, values);
+        for (int c = 0; c < Components; ++c) {
+            stream[c * padded + i] = values[c];
+        }
+    }
+    return stream;
+}
+
+// Size and modification time identify a version of the source file
+static bool getSourceStamp(const std::string& path, uint64_t& size, int64_t& time) {
+    std::error_code error;
+    uintmax_t fileSize = std::filesystem::file_size(path, error);
+    if (error) return false;
+    std::filesystem::file_time_type modified = std::filesystem::last_write_time(path, error);
+    if (error) return false;
+
+    size = static_cast<uint64_t>(fileSize);
+    time = static_cast<int64_t>(modified.time_since_epoch().count());
+    return true;
+}
+
+bool MeshCache::write(const Mesh& mesh, const std::string& cachePath, const std::string& sourcePath) {
+    TRACE_SCOPE("MeshCache::write");
+    size_t vertexCount = mesh.getVertexCount();
+    size_t indexCount = mesh.getIndexCount();
+    const unsigned int* indexData = mesh.getIndexData();
+
+    // Never write a cache the renderer could index out of bounds with
+    if (indexCount % 3 != 0) return false;
+    for (size_t i = 0; i < indexCount; ++i) {
+        if (indexData[i] >= vertexCount) return false;
+    }
+
+    MeshCacheHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = FORMAT_VERSION;
+    header.endianTag = ENDIAN_TAG;
+    header.vertexCount = vertexCount;
+    header.paddedVertexCount = (vertexCount + PositionStream::PADDING - 1) / PositionStream::PADDING * PositionStream::PADDING;
+    header.indexCount = indexCount;
+
+    size_t padded = header.paddedVertexCount;
+    std::vector<float> positions = makeStream<3>(vertexCount, padded, [&](size_t i, float* out) {
+        Vector3 position = mesh.getVertexPosition(i);
+        out[0] = position.x; out[1] = position.y; out[2] = position.z;
+    });
+    std::vector<float> normals;
+    if (mesh.hasVertexNormals()) {
+        normals = makeStream<3>(vertexCount, padded, [&](size_t i, float* out) {
+            Vector3 normal = mesh.getVertex(i).normal;
+            out[0] = normal.x; out[1] = normal.y; out[2] = normal.z;
+        });
+    }
+    std::vector<float> texCoords;
+    if (mesh.hasTexCoords()) {
+        texCoords = makeStream<2>(vertexCount, padded, [&](size_t i, float* out) {
+            Vertex vertex = mesh.getVertex(i);
+            out[0] = vertex.u; out[1] = vertex.v;
+        });
+    }
+
+    // Blocks in file order; absent attributes keep a zero offset
+    struct Block {
+        uint64_t* offset;
+        const void* data;
+        uint64_t bytes;
+        bool present;
+    };
+    Block blocks[] = {
+        { &header.positionsOffset, positions.data(), positions.size() * sizeof(float), true },
+        { &header.indicesOffset, indexData, indexCount * sizeof(unsigned int), true },
+        { &header.normalsOffset, normals.data(), normals.size() * sizeof(float), mesh.hasVertexNormals() },
+        { &header.texCoordsOffset, texCoords.data(), texCoords.size() * sizeof(float), mesh.hasTexCoords() },
+    };
+    uint64_t end = sizeof(MeshCacheHeader);
+    for (Block& block : blocks) {
+        if (!block.present) continue;
+        *block.offset = alignOffset(end);
+        end = *block.offset + block.bytes;
+    }
+    header.fileSize = end;
+
+    if (!sourcePath.empty() && !getSourceStamp(sourcePath, header.sourceSize, header.sourceTime)) {
+        return false;
+    }
+
+    const AABB& bounds = mesh.getBounds();
+    const BoundingSphere& sphere = mesh.getBoundingSphere();
+    header.boundsMin[0] = bounds.min.x; header.boundsMin[1] = bounds.min.y; header.boundsMin[2] = bounds.min.z;
+    header.boundsMax[0] = bounds.max.x; header.boundsMax[1] = bounds.max.y; header.boundsMax[2] = bounds.max.z;
+    header.sphereCenter[0] = sphere.center.x; header.sphereCenter[1] = sphere.center.y; header.sphereCenter[2] = sphere.center.z;
+    header.sphereRadius = sphere.radius;
+
+    // Write to a temporary file and rename, so readers never see a partial cache
+    std::string temporaryPath = cachePath + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return false;
+
+        const char zeros[BLOCK_ALIGNMENT] = {};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        uint64_t written = sizeof(header);
+        for (const Block& block : blocks) {
+            if (!block.present) continue;
+            file.write(zeros, *block.offset - written);
+            file.write(reinterpret_cast<const char*>(block.data), block.bytes);
+            written = *block.offset + block.bytes;
+        }
+        if (!file) {
+            file.close();
+            std::remove(temporaryPath.c_str());
+            return false;
+        }
+    }
+
+    if (std::rename(temporaryPath.c_str(), cachePath.c_str()) != 0) {
+        std::remove(temporaryPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool MeshCache::read(const std::string& cachePath, Mesh& mesh, const std::string& sourcePath) {
+    TRACE_SCOPE("MeshCache::read");
+    std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>();
+    if (!file->open(cachePath) || file->size() < sizeof(MeshCacheHeader)) return false;
+
+    MeshCacheHeader header;
+    std::memcpy(&header, file->data(), sizeof(header));
+
+    // Reject foreign, outdated or truncated files before touching any block
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) return false;
+    if (header.version != FORMAT_VERSION || header.endianTag != ENDIAN_TAG) return false;
+    if (header.fileSize != file->size()) return false;
+    if (header.paddedVertexCount < header.vertexCount ||
+        header.paddedVertexCount % PositionStream::PADDING != 0 ||
+        header.paddedVertexCount > header.fileSize / sizeof(float) ||
+        header.indexCount > header.fileSize / sizeof(unsigned int) ||
+        header.indexCount % 3 != 0) return false;
+
+    uint64_t streamBytes = header.paddedVertexCount * sizeof(float);
+    if (!isBlockValid(header, header.positionsOffset, 3 * streamBytes) ||
+        !isBlockValid(header, header.indicesOffset, header.indexCount * sizeof(unsigned int))) return false;
+    if (header.normalsOffset != 0 && !isBlockValid(header, header.normalsOffset, 3 * streamBytes)) return false;
+    if (header.texCoordsOffset != 0 && !isBlockValid(header, header.texCoordsOffset, 2 * streamBytes)) return false;
+
+    if (!sourcePath.empty()) {
+        uint64_t sourceSize;
+        int64_t sourceTime;
+        if (!getSourceStamp(sourcePath, sourceSize, sourceTime)) return false;
+        if (sourceSize != header.sourceSize || sourceTime != header.sourceTime) return false;
+    }
+
+    const unsigned char* base = file->data();
+    const float* x = reinterpret_cast<const float*>(base + header.positionsOffset);
+    const float* y = x + header.paddedVertexCount;
+    const float* z = y + header.paddedVertexCount;
+    const unsigned int* indexData = reinterpret_cast<const unsigned int*>(base + header.indicesOffset);
+
+    // The header checks cannot catch a damaged index block, and the renderer
+    // uses indices unchecked (a pass over them is cheap next to the mapping)
+    for (uint64_t i = 0; i < header.indexCount; ++i) {
+        if (indexData[i] >= header.vertexCount) return false;
+    }
+
+    AABB bounds(Vector3(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]),
+                Vector3(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]));
+    BoundingSphere sphere(Vector3(header.sphereCenter[0], header.sphereCenter[1], header.sphereCenter[2]),
+                          header.sphereRadius);
+
+    // Same starting state as loadFromOBJ, then point the mesh at the mapping
+    mesh.clear();
+    mesh.attachExternalGeometry(file, x, y, z, header.vertexCount, header.paddedVertexCount,
+                                indexData, header.indexCount, bounds, sphere);
+    if (header.normalsOffset != 0) {
+        const float* nx = reinterpret_cast<const float*>(base + header.normalsOffset);
+        mesh.attachExternalNormals(nx, nx + header.paddedVertexCount, nx + 2 * header.paddedVertexCount);
+    }
+    if (header.texCoordsOffset != 0) {
+        const float* u = reinterpret_cast<const float*>(base + header.texCoordsOffset);
+        mesh.attachExternalTexCoords(u, u + header.paddedVertexCount);
+    }
+    return true;
+}
+
+bool MeshCache::convertOBJ(const std::string& objPath, const std::string& cachePath) {
+    Mesh mesh;
+    if (!mesh.loadFromOBJ(objPath)) return false;
+    return write(mesh, cachePath, objPath);
+}
+
+bool MeshCache::load(const std::string& objPath, Mesh& mesh, const std::string& cachePath) {
+    TRACE_SCOPE("MeshCache::load");
+    std::string path = cachePath.empty() ? getDefaultCachePath(objPath) : cachePath;
+    if (read(path, mesh, objPath)) return true;
+
+    // Cache missing or stale: parse the source and regenerate it for next time
+    if (!mesh.loadFromOBJ(objPath)) return false;
+    write(mesh, path, objPath);
+    return true;
+}
@@ -0,0 +1,245 @@
+#include "MeshData.hpp"
+#include <algorithm>
+#include <cmath>
+
+unsigned int MeshData::addVertex(const Vertex& vertex) {
+    makeGeometryOwned();
+    
+    // Duplicates are kept; MeshOptimizer::weldVertices() merges them afterwards
+    vertices.push_back(vertex);
+    
+    // Append to the SoA stream, growing it one padded block at a time
+    if (positions.count == positions.x.size()) {
+        size_t paddedSize = positions.x.size() + PositionStream::PADDING;
+        positions.x.resize(paddedSize, 0.0f);
+        positions.y.resize(paddedSize, 0.0f);
+        positions.z.resize(paddedSize, 0.0f);
+    }
+    positions.x[positions.count] = vertex.position.x;
+    positions.y[positions.count] = vertex.position.y;
+    positions.z[positions.count] = vertex.position.z;
+    ++positions.count;
+    
+    bounds.expand(vertex.position);
+    boundingSphere.expand(vertex.position);
+    
+    return static_cast<unsigned int>(vertices.size() - 1);
+}
+
+void MeshData::addTriangle(unsigned int i0, unsigned int i1, unsigned int i2) {
+    makeGeometryOwned();
+    lods.clear();
+    
+    // Add three indices that form a triangle
+    indices.push_back(i0);
+    indices.push_back(i1);
+    indices.push_back(i2);
+}
+
+void MeshData::addTriangle(const Triangle& tri) {
+    // Add vertices and get their indices
+    unsigned int i0 = addVertex(tri.v0);
+    unsigned int i1 = addVertex(tri.v1);
+    unsigned int i2 = addVertex(tri.v2);
+    
+    // Add triangle using indices
+    addTriangle(i0, i1, i2);
+}
+
+Triangle MeshData::getTriangle(size_t triangleIndex) const {
+    // Validate triangle index
+    if (triangleIndex >= getTriangleCount()) {
+        // Return a default triangle if index is out of bounds
+        return Triangle(Vertex(), Vertex(), Vertex());
+    }
+    
+    // Get the three vertex indices for this triangle
+    const unsigned int* indexData = getIndexData();
+    size_t baseIndex = triangleIndex * 3;
+    unsigned int i0 = indexData[baseIndex];
+    unsigned int i1 = indexData[baseIndex + 1];
+    unsigned int i2 = indexData[baseIndex + 2];
+    
+    // Reconstruct triangle from vertex buffer
+    return Triangle(getVertex(i0), getVertex(i1), getVertex(i2));
+}
+
+PositionStreamView MeshData::getPositionStreamView() const {
+    if (hasExternalGeometry()) {
+        return PositionStreamView{ external.x, external.y, external.z,
+                                   external.vertexCount, external.paddedVertexCount };
+    }
+    return PositionStreamView{ positions.x.data(), positions.y.data(), positions.z.data(),
+                               positions.count, positions.x.size() };
+}
+
+Vector3 MeshData::getVertexPosition(size_t index) const {
+    if (hasExternalGeometry()) {
+        return Vector3(external.x[index], external.y[index], external.z[index]);
+    }
+    return vertices[index].position;
+}
+
+Vector3 MeshData::getVertexNormal(size_t index) const {
+    if (hasExternalGeometry()) {
+        return external.nx ? Vector3(external.nx[index], external.ny[index], external.nz[index]) : Vector3();
+    }
+    return vertices[index].normal;
+}
+
+void MeshData::getVertexTexCoord(size_t index, float& u, float& v) const {
+    if (!hasExternalGeometry()) {
+        u = vertices[index].u;
+        v = vertices[index].v;
+    } else if (external.u) {
+        u = external.u[index];
+        v = external.v[index];
+    } else {
+        u = v = 0.0f;
+    }
+}
+
+Vertex MeshData::getVertex(size_t index) const {
+    if (!hasExternalGeometry()) {
+        return vertices[index];
+    }
+    
+    Vertex vertex(Vector3(external.x[index], external.y[index], external.z[index]));
+    if (external.nx) {
+        vertex.normal = Vector3(external.nx[index], external.ny[index], external.nz[index]);
+    }
+    if (external.u) {
+        vertex.u = external.u[index];
+        vertex.v = external.v[index];
+    }
+    return vertex;
+}
+
+void MeshData::attachExternalGeometry(std::shared_ptr<const void> owner,
+                                  const float* x, const float* y, const float* z,
+                                  size_t vertexCount, size_t paddedVertexCount,
+                                  const unsigned int* indexData, size_t indexCount,
+                                  const AABB& objectBounds, const BoundingSphere& objectSphere) {
+    // Drop owned geometry (and its memory)
+    std::vector<Vertex>().swap(vertices);
+    std::vector<unsigned int>().swap(indices);
+    positions = PositionStream();
+    
+    external.owner = std::move(owner);
+    external.x = x;
+    external.y = y;
+    external.z = z;
+    external.vertexCount = vertexCount;
+    external.paddedVertexCount = paddedVertexCount;
+    external.indices = indexData;
+    external.indexCount = indexCount;
+    
+    bounds = objectBounds;
+    boundingSphere = objectSphere;
+    lods.clear();
+    vertexNormals = false;
+    vertexTexCoords = false;
+}
+
+void MeshData::attachExternalNormals(const float* nx, const float* ny, const float* nz) {
+    external.nx = nx;
+    external.ny = ny;
+    external.nz = nz;
+    vertexNormals = true;
+}
+
+void MeshData::attachExternalTexCoords(const float* u, const float* v) {
+    external.u = u;
+    external.v = v;
+    vertexTexCoords = true;
+}
+
+void MeshData::makeGeometryOwned() {
+    if (!hasExternalGeometry()) return;
+    
+    // Copy-on-write: take a private copy, then release the external memory
+    size_t vertexCount = getVertexCount();
+    vertices.resize(vertexCount);
+    for (size_t i = 0; i < vertexCount; ++i) {
+        vertices[i] = getVertex(i);
+    }
+    
+    ExternalGeometry source = std::move(external);
+    external = ExternalGeometry();
+    indices.assign(source.indices, source.indices + source.indexCount);
+    updatePositionStream();
+}
+
+void MeshData::updatePositionStream() {
+    makeGeometryOwned();
+    
+    size_t count = vertices.size();
+    size_t paddedSize = (count + PositionStream::PADDING - 1) / PositionStream::PADDING * PositionStream::PADDING;
+    
+    positions.x.assign(paddedSize, 0.0f);
+    positions.y.assign(paddedSize, 0.0f);
+    positions.z.assign(paddedSize, 0.0f);
+    for (size_t i = 0; i < count; ++i) {
+        positions.x[i] = vertices[i].position.x;
+        positions.y[i] = vertices[i].position.y;
+        positions.z[i] = vertices[i].position.z;
+    }
+    positions.count = count;
+}
+
+void MeshData::updateBounds() {
+    makeGeometryOwned();
+    
+    bounds = AABB();
+    for (const Vertex& vertex : vertices) {
+        bounds.expand(vertex.position);
+    }
+    
+    // Sphere around the box center: tighter than growing it vertex by vertex
+    boundingSphere = BoundingSphere();
+    if (!bounds.isEmpty()) {
+        Vector3 center = bounds.getCenter();
+        float radiusSq = 0.0f;
+        for (const Vertex& vertex : vertices) {
+            Vector3 offset = vertex.position - center;
+            radiusSq = std::max(radiusSq, offset.dot(offset));
+        }
+        boundingSphere = BoundingSphere(center, std::sqrt(radiusSq));
+    }
+}
+
+void MeshData::clear() {
+    external = ExternalGeometry();
+    lods.clear();
+    vertexNormals = false;
+    vertexTexCoords = false;
+    vertices.clear();
+    indices.clear();
+    positions.x.clear();
+    positions.y.clear();
+    positions.z.clear();
+    positions.count = 0;
+    bounds = AABB();
+    boundingSphere = BoundingSphere();
+}
+
+void MeshData::reserve(size_t vertexCount, size_t triangleCount) {
+    makeGeometryOwned();
+    vertices.reserve(vertexCount);
+    size_t paddedCount = vertexCount + PositionStream::PADDING;
+    positions.x.reserve(paddedCount);
+    positions.y.reserve(paddedCount);
+    positions.z.reserve(paddedCount);
+    indices.reserve(triangleCount * 3); // 3 indices per triangle
+}
+
+size_t MeshData::getMemoryUsage() const {
+    size_t bytes = sizeof(MeshData);
+    bytes += vertices.capacity() * sizeof(Vertex);
+    bytes += indices.capacity() * sizeof(unsigned int);
+    bytes += (positions.x.capacity() + positions.y.capacity() + positions.z.capacity()) * sizeof(float);
+    for (const MeshLOD& level : lods) {
+        bytes += sizeof(MeshLOD) + level.indices.capacity() * sizeof(unsigned int);
+    }
+    return bytes;
+}
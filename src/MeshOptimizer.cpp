@@ -0,0 +1,402 @@
+#include "MeshOptimizer.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+
+// A cluster may be split off early while its ACMR stays within this factor
+// of the whole cluster's ACMR
+const float OVERDRAW_THRESHOLD = 1.05f;
+
+// Hash-table marker for an empty chain
+const unsigned int NO_VERTEX = 0xFFFFFFFFu;
+
+// FIFO post-transform cache model using timestamps: a vertex is cached while
+// fewer than `size` misses happened since it was loaded
+class FifoCache {
+public:
+    FifoCache(size_t vertexCount, unsigned int size) : stamps(vertexCount, 0), size(size), time(size + 1) {}
+
+    // True on a hit; a miss loads the vertex
+    bool access(unsigned int vertex) {
+        if (time - stamps[vertex] <= size) return true;
+        stamps[vertex] = time++;
+        return false;
+    }
+
+    // Misses since the vertex was loaded (greater than size once evicted)
+    unsigned int getAge(unsigned int vertex) const { return time - stamps[vertex]; }
+    unsigned int getSize() const { return size; }
+
+    // Evict everything
+    void flush() { time += size + 1; }
+
+private:
+    std::vector<unsigned int> stamps;
+    unsigned int size;
+    unsigned int time;
+};
+
+unsigned int countMisses(FifoCache& cache, const unsigned int* triangle) {
+    return !cache.access(triangle[0]) + !cache.access(triangle[1]) + !cache.access(triangle[2]);
+}
+
+bool isWithin(const Vertex& a, const Vertex& b, float tolerance) {
+    return std::fabs(a.position.x - b.position.x) <= tolerance &&
+           std::fabs(a.position.y - b.position.y) <= tolerance &&
+           std::fabs(a.position.z - b.position.z) <= tolerance &&
+           std::fabs(a.normal.x - b.normal.x) <= tolerance &&
+           std::fabs(a.normal.y - b.normal.y) <= tolerance &&
+           std::fabs(a.normal.z - b.normal.z) <= tolerance &&
+           std::fabs(a.u - b.u) <= tolerance &&
+           std::fabs(a.v - b.v) <= tolerance;
+}
+
+// Spatial hash cell of a position. With no tolerance the float bits are used
+// directly, so only identical positions share a cell.
+void getCell(const Vector3& position, float cellSize, long long cell[3]) {
+    const float coordinates[3] = { position.x + 0.0f, position.y + 0.0f, position.z + 0.0f };   // -0 -> +0
+    for (int i = 0; i < 3; ++i) {
+        if (cellSize > 0.0f) {
+            cell[i] = static_cast<long long>(std::floor(static_cast<double>(coordinates[i]) / cellSize));
+        } else {
+            uint32_t bits;
+            std::memcpy(&bits, &coordinates[i], sizeof(bits));
+            cell[i] = bits;
+        }
+    }
+}
+
+uint64_t hashCell(long long x, long long y, long long z) {
+    // Teschner et al., "Optimized Spatial Hashing for Collision Detection of Deformable Objects"
+    return static_cast<uint64_t>(x) * 73856093u ^ static_cast<uint64_t>(y) * 19349663u ^
+           static_cast<uint64_t>(z) * 83492791u;
+}
+
+// Edits through `vertices` bypass the position stream and bounds
+void finishGeometryEdit(MeshData& data) {
+    data.updatePositionStream();
+    data.updateBounds();
+}
+
+} // namespace
+
+MeshOptimizeStats MeshOptimizer::optimize(Mesh& mesh, float weldTolerance, unsigned int cacheSize) {
+    TRACE_SCOPE("MeshOptimizer::optimize");
+    MeshOptimizeStats stats;
+    stats.verticesBefore = mesh.getVertexCount();
+    stats.trianglesBefore = mesh.getTriangleCount();
+    stats.acmrBefore = computeACMR(mesh.getIndexData(), mesh.getIndexCount(), mesh.getVertexCount(), cacheSize);
+
+    weldVertices(mesh, weldTolerance);
+    optimizeVertexCache(mesh, cacheSize);
+    optimizeOverdraw(mesh, cacheSize);
+    optimizeVertexFetch(mesh);
+
+    stats.verticesAfter = mesh.getVertexCount();
+    stats.trianglesAfter = mesh.getTriangleCount();
+    stats.acmrAfter = computeACMR(mesh.getIndexData(), mesh.getIndexCount(), mesh.getVertexCount(), cacheSize);
+    return stats;
+}
+
+size_t MeshOptimizer::weldVertices(Mesh& mesh, float tolerance) {
+    MeshData& data = mesh.editGeometry();
+    data.makeGeometryOwned();
+    data.clearLODs();
+    std::vector<Vertex>& vertices = data.vertices;
+    size_t vertexCount = vertices.size();
+
+    // Welded vertices chained per hash cell, in order of first occurrence
+    std::unordered_map<uint64_t, unsigned int> cellHeads;
+    cellHeads.reserve(vertexCount);
+    std::vector<unsigned int> nextInCell;
+    std::vector<Vertex> welded;
+    std::vector<unsigned int> remap(vertexCount);
+
+    // Vertices within the tolerance can sit in neighbouring cells
+    int searchRadius = tolerance > 0.0f ? 1 : 0;
+
+    for (size_t i = 0; i < vertexCount; ++i) {
+        long long cell[3];
+        getCell(vertices[i].position, tolerance, cell);
+
+        unsigned int match = NO_VERTEX;
+        for (int dx = -searchRadius; dx <= searchRadius && match == NO_VERTEX; ++dx) {
+            for (int dy = -searchRadius; dy <= searchRadius && match == NO_VERTEX; ++dy) {
+                for (int dz = -searchRadius; dz <= searchRadius && match == NO_VERTEX; ++dz) {
+                    auto head = cellHeads.find(hashCell(cell[0] + dx, cell[1] + dy, cell[2] + dz));
+                    if (head == cellHeads.end()) continue;
+
+                    for (unsigned int w = head->second; w != NO_VERTEX; w = nextInCell[w]) {
+                        if (isWithin(welded[w], vertices[i], tolerance)) {
+                            match = w;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+
+        if (match == NO_VERTEX) {
+            match = static_cast<unsigned int>(welded.size());
+            welded.push_back(vertices[i]);
+
+            auto head = cellHeads.emplace(hashCell(cell[0], cell[1], cell[2]), NO_VERTEX).first;
+            nextInCell.push_back(head->second);
+            head->second = match;
+        }
+        remap[i] = match;
+    }
+
+    // Rewrite the triangles, dropping the ones that collapsed
+    std::vector<unsigned int>& indices = data.indices;
+    size_t kept = 0;
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        unsigned int a = remap[indices[i]];
+        unsigned int b = remap[indices[i + 1]];
+        unsigned int c = remap[indices[i + 2]];
+        if (a == b || b == c || c == a) continue;
+
+        indices[kept++] = a;
+        indices[kept++] = b;
+        indices[kept++] = c;
+    }
+    indices.resize(kept);
+
+    size_t removed = vertexCount - welded.size();
+    vertices = std::move(welded);
+    finishGeometryEdit(data);
+    return removed;
+}
+
+void MeshOptimizer::optimizeVertexCache(Mesh& mesh, unsigned int cacheSize) {
+    // Sander, Nehab and Barczak, "Fast Triangle Reordering for Vertex Locality
+    // and Reduced Overdraw" (Tipsify): emit all remaining triangles around a
+    // fanning vertex, then continue with the neighbour that will still be in
+    // the cache once its own triangles are emitted.
+    MeshData& data = mesh.editGeometry();
+    data.makeGeometryOwned();
+    data.clearLODs();
+    std::vector<unsigned int>& indices = data.indices;
+    size_t vertexCount = data.vertices.size();
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) return;
+
+    // Triangles using each vertex
+    std::vector<unsigned int> adjacencyOffset(vertexCount + 1, 0);
+    for (size_t i = 0; i < triangleCount * 3; ++i) {
+        ++adjacencyOffset[indices[i] + 1];
+    }
+    for (size_t v = 0; v < vertexCount; ++v) {
+        adjacencyOffset[v + 1] += adjacencyOffset[v];
+    }
+    std::vector<unsigned int> adjacency(triangleCount * 3);
+    std::vector<unsigned int> fillOffset(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+    for (size_t i = 0; i < triangleCount * 3; ++i) {
+        adjacency[fillOffset[indices[i]]++] = static_cast<unsigned int>(i / 3);
+    }
+
+    // Triangles not yet emitted per vertex
+    std::vector<unsigned int> liveTriangles(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        liveTriangles[v] = adjacencyOffset[v + 1] - adjacencyOffset[v];
+    }
+
+    FifoCache cache(vertexCount, cacheSize);
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<unsigned int> deadEnd;
+    std::vector<unsigned int> candidates;
+    std::vector<unsigned int> output;
+    output.reserve(triangleCount * 3);
+    size_t cursor = 0;
+
+    // Fallback when no neighbour qualifies: recently used vertices first, then input order
+    auto skipDeadEnd = [&]() -> unsigned int {
+        while (!deadEnd.empty()) {
+            unsigned int vertex = deadEnd.back();
+            deadEnd.pop_back();
+            if (liveTriangles[vertex] > 0) return vertex;
+        }
+        for (; cursor < vertexCount; ++cursor) {
+            if (liveTriangles[cursor] > 0) return static_cast<unsigned int>(cursor);
+        }
+        return NO_VERTEX;
+    };
+
+    unsigned int fanning = skipDeadEnd();
+    while (fanning != NO_VERTEX) {
+        candidates.clear();
+        for (unsigned int a = adjacencyOffset[fanning]; a < adjacencyOffset[fanning + 1]; ++a) {
+            unsigned int triangle = adjacency[a];
+            if (emitted[triangle]) continue;
+            emitted[triangle] = true;
+
+            for (int k = 0; k < 3; ++k) {
+                unsigned int vertex = indices[triangle * 3 + k];
+                output.push_back(vertex);
+                deadEnd.push_back(vertex);
+                candidates.push_back(vertex);
+                --liveTriangles[vertex];
+                cache.access(vertex);
+            }
+        }
+
+        // Prefer the candidate that stays cached through its remaining triangles
+        // (each costs at most two new vertices) and has been cached the longest
+        unsigned int best = NO_VERTEX;
+        int bestPriority = -1;
+        for (unsigned int vertex : candidates) {
+            if (liveTriangles[vertex] == 0) continue;
+
+            int priority = 0;
+            if (cache.getAge(vertex) + 2 * liveTriangles[vertex] <= cacheSize) {
+                priority = static_cast<int>(cache.getAge(vertex));
+            }
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                best = vertex;
+            }
+        }
+
+        fanning = best != NO_VERTEX ? best : skipDeadEnd();
+    }
+
+    indices = std::move(output);
+}
+
+void MeshOptimizer::optimizeOverdraw(Mesh& mesh, unsigned int cacheSize) {
+    MeshData& data = mesh.editGeometry();
+    data.makeGeometryOwned();
+    data.clearLODs();
+    std::vector<unsigned int>& indices = data.indices;
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) return;
+
+    // Split the order into clusters. Hard boundaries are triangles that miss on
+    // all three vertices (where the cache order restarts anyway); inside those,
+    // a cluster is also cut once its ACMR, counted from a cold cache, is within
+    // OVERDRAW_THRESHOLD of the enclosing cluster's.
+    std::vector<size_t> clusterStarts;
+    {
+        FifoCache cache(data.vertices.size(), cacheSize);
+        std::vector<size_t> hardStarts;
+        for (size_t t = 0; t < triangleCount; ++t) {
+            if (countMisses(cache, &indices[t * 3]) == 3) hardStarts.push_back(t);
+        }
+        hardStarts.push_back(triangleCount);
+        if (hardStarts.front() != 0) hardStarts.insert(hardStarts.begin(), 0);
+
+        for (size_t h = 0; h + 1 < hardStarts.size(); ++h) {
+            size_t first = hardStarts[h];
+            size_t last = hardStarts[h + 1];
+
+            cache.flush();
+            unsigned int hardMisses = 0;
+            for (size_t t = first; t < last; ++t) hardMisses += countMisses(cache, &indices[t * 3]);
+            float hardACMR = static_cast<float>(hardMisses) / (last - first);
+
+            cache.flush();
+            size_t start = first;
+            unsigned int misses = 0;
+            clusterStarts.push_back(first);
+            for (size_t t = first; t + 1 < last; ++t) {
+                misses += countMisses(cache, &indices[t * 3]);
+                if (static_cast<float>(misses) / (t + 1 - start) <= hardACMR * OVERDRAW_THRESHOLD) {
+                    start = t + 1;
+                    misses = 0;
+                    clusterStarts.push_back(start);
+                    cache.flush();
+                }
+            }
+        }
+        clusterStarts.push_back(triangleCount);
+    }
+
+    size_t clusterCount = clusterStarts.size() - 1;
+    if (clusterCount < 2) return;
+
+    // Area-weighted centroid and normal of each cluster and of the whole mesh
+    std::vector<Vector3> clusterCentroids(clusterCount);
+    std::vector<Vector3> clusterNormals(clusterCount);
+    Vector3 meshCentroid(0, 0, 0);
+    float meshArea = 0.0f;
+    for (size_t c = 0; c < clusterCount; ++c) {
+        Vector3 centroid(0, 0, 0);
+        Vector3 normal(0, 0, 0);
+        float area = 0.0f;
+        for (size_t t = clusterStarts[c]; t < clusterStarts[c + 1]; ++t) {
+            const Vector3& p0 = data.vertices[indices[t * 3]].position;
+            const Vector3& p1 = data.vertices[indices[t * 3 + 1]].position;
+            const Vector3& p2 = data.vertices[indices[t * 3 + 2]].position;
+
+            Vector3 cross = (p1 - p0).cross(p2 - p0);   // Twice the area, counter-clockwise front faces point out
+            float triangleArea = cross.length();
+            centroid = centroid + (p0 + p1 + p2) * (triangleArea / 3.0f);
+            normal = normal + cross;
+            area += triangleArea;
+        }
+        clusterCentroids[c] = area > 0.0f ? centroid * (1.0f / area) : centroid;
+        clusterNormals[c] = normal;
+        meshCentroid = meshCentroid + centroid;
+        meshArea += area;
+    }
+    if (meshArea > 0.0f) meshCentroid = meshCentroid * (1.0f / meshArea);
+
+    // Clusters far out along their own normal are likely in front of the rest
+    std::vector<float> sortKeys(clusterCount);
+    for (size_t c = 0; c < clusterCount; ++c) {
+        float length = clusterNormals[c].length();
+        sortKeys[c] = length > 0.0f ? (clusterCentroids[c] - meshCentroid).dot(clusterNormals[c]) / length : 0.0f;
+    }
+
+    std::vector<size_t> clusterOrder(clusterCount);
+    for (size_t c = 0; c < clusterCount; ++c) clusterOrder[c] = c;
+    std::stable_sort(clusterOrder.begin(), clusterOrder.end(),
+                     [&](size_t a, size_t b) { return sortKeys[a] > sortKeys[b]; });
+
+    std::vector<unsigned int> output;
+    output.reserve(indices.size());
+    for (size_t c : clusterOrder) {
+        output.insert(output.end(), indices.begin() + clusterStarts[c] * 3, indices.begin() + clusterStarts[c + 1] * 3);
+    }
+    indices = std::move(output);
+}
+
+void MeshOptimizer::optimizeVertexFetch(Mesh& mesh) {
+    MeshData& data = mesh.editGeometry();
+    data.makeGeometryOwned();
+    data.clearLODs();
+    std::vector<Vertex>& vertices = data.vertices;
+    std::vector<unsigned int>& indices = data.indices;
+
+    std::vector<unsigned int> remap(vertices.size(), NO_VERTEX);
+    std::vector<Vertex> reordered;
+    reordered.reserve(vertices.size());
+    for (unsigned int& index : indices) {
+        if (remap[index] == NO_VERTEX) {
+            remap[index] = static_cast<unsigned int>(reordered.size());
+            reordered.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+
+    vertices = std::move(reordered);
+    finishGeometryEdit(data);
+}
+
+float MeshOptimizer::computeACMR(const unsigned int* indices, size_t indexCount, size_t vertexCount,
+                                 unsigned int cacheSize) {
+    size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0) return 0.0f;
+
+    FifoCache cache(vertexCount, cacheSize);
+    size_t misses = 0;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        misses += countMisses(cache, indices + t * 3);
+    }
+    return static_cast<float>(misses) / triangleCount;
+}
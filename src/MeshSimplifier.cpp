@@ -0,0 +1,420 @@
+#include "MeshSimplifier.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <queue>
+#include <unordered_map>
+
+namespace {
+
+const unsigned int NO_VERTEX = 0xFFFFFFFFu;
+
+// Border planes are weighted this much more than surface planes so that open
+// borders keep their outline
+const double BORDER_WEIGHT = 10.0;
+
+// Collapses may not turn a remaining triangle by more than about 60 degrees,
+// which also rejects flips and the slivers that shade badly
+const float MIN_NORMAL_COSINE = 0.5f;
+
+// A level must have at most this fraction of the previous level's triangles
+const float MIN_LOD_PROGRESS = 0.85f;
+
+enum VertexKind : unsigned char {
+    VERTEX_MANIFOLD,    // Interior vertex, may collapse into any neighbour
+    VERTEX_BORDER,      // On an open border, may only collapse along it
+    VERTEX_LOCKED       // Attribute seam or non-manifold, never removed
+};
+
+// Sum of weighted squared distances to a set of planes, as the symmetric
+// 4x4 matrix of Garland and Heckbert. The total weight turns the sum into a
+// mean, which makes the error a distance in object units.
+struct Quadric {
+    double a2 = 0, ab = 0, ac = 0, ad = 0;
+    double b2 = 0, bc = 0, bd = 0;
+    double c2 = 0, cd = 0;
+    double d2 = 0;
+    double weight = 0;
+
+    void addPlane(double a, double b, double c, double d, double w) {
+        a2 += w * a * a; ab += w * a * b; ac += w * a * c; ad += w * a * d;
+        b2 += w * b * b; bc += w * b * c; bd += w * b * d;
+        c2 += w * c * c; cd += w * c * d;
+        d2 += w * d * d;
+        weight += w;
+    }
+
+    void add(const Quadric& q) {
+        a2 += q.a2; ab += q.ab; ac += q.ac; ad += q.ad;
+        b2 += q.b2; bc += q.bc; bd += q.bd;
+        c2 += q.c2; cd += q.cd;
+        d2 += q.d2;
+        weight += q.weight;
+    }
+
+    double evaluate(const Vector3& p) const {
+        double x = p.x, y = p.y, z = p.z;
+        return a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x +
+               b2 * y * y + 2 * bc * y * z + 2 * bd * y +
+               c2 * z * z + 2 * cd * z +
+               d2;
+    }
+};
+
+// Mean squared distance from `p` to the planes of both quadrics
+double getCollapseCost(const Quadric& a, const Quadric& b, const Vector3& p) {
+    double weight = a.weight + b.weight;
+    if (weight <= 0.0) return 0.0;
+    return std::max(0.0, (a.evaluate(p) + b.evaluate(p)) / weight);
+}
+
+struct Collapse {
+    double cost;
+    unsigned int from;
+    unsigned int to;
+    unsigned int version;   // `from`'s version when the collapse was evaluated
+
+    bool operator>(const Collapse& other) const { return cost > other.cost; }
+};
+
+class Simplifier {
+public:
+    Simplifier(const Mesh& mesh, const unsigned int* indices, size_t indexCount)
+        : vertexCount(mesh.getVertexCount()), triangles(indices, indices + indexCount) {
+        positions.resize(vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v) {
+            positions[v] = mesh.getVertexPosition(v);
+        }
+
+        size_t triangleCount = triangles.size() / 3;
+        liveTriangleCount = triangleCount;
+        triangleAlive.assign(triangleCount, true);
+        adjacency.resize(vertexCount);
+        for (size_t t = 0; t < triangleCount; ++t) {
+            for (int k = 0; k < 3; ++k) {
+                adjacency[triangles[t * 3 + k]].push_back(static_cast<unsigned int>(t));
+            }
+        }
+
+        classifyVertices();
+        buildQuadrics();
+    }
+
+    std::vector<unsigned int> run(size_t targetIndexCount, float maxError, float* resultError) {
+        double maxCost = static_cast<double>(maxError) * maxError;
+        double worstCost = 0.0;
+
+        versions.assign(vertexCount, 0);
+        vertexAlive.assign(vertexCount, true);
+        for (size_t v = 0; v < vertexCount; ++v) {
+            pushBestCollapse(static_cast<unsigned int>(v));
+        }
+
+        while (liveTriangleCount * 3 > targetIndexCount && !queue.empty()) {
+            Collapse collapse = queue.top();
+            queue.pop();
+            if (collapse.cost > maxCost) break;
+            if (!vertexAlive[collapse.from] || !vertexAlive[collapse.to]) continue;
+            if (collapse.version != versions[collapse.from]) continue;
+            if (!isCollapseValid(collapse.from, collapse.to)) continue;
+
+            worstCost = std::max(worstCost, collapse.cost);
+            performCollapse(collapse.from, collapse.to);
+        }
+
+        if (resultError) *resultError = static_cast<float>(std::sqrt(worstCost));
+
+        std::vector<unsigned int> result;
+        result.reserve(liveTriangleCount * 3);
+        for (size_t t = 0; t < triangleAlive.size(); ++t) {
+            if (!triangleAlive[t]) continue;
+            result.insert(result.end(), triangles.begin() + t * 3, triangles.begin() + t * 3 + 3);
+        }
+        return result;
+    }
+
+private:
+    static uint64_t edgeKey(unsigned int a, unsigned int b) {
+        if (a > b) std::swap(a, b);
+        return (static_cast<uint64_t>(a) << 32) | b;
+    }
+
+    void classifyVertices() {
+        kinds.assign(vertexCount, VERTEX_MANIFOLD);
+
+        // Edges used by one triangle are borders, by more than two non-manifold
+        std::unordered_map<uint64_t, unsigned int> edgeUse;
+        edgeUse.reserve(triangles.size());
+        for (size_t i = 0; i < triangles.size(); i += 3) {
+            for (int k = 0; k < 3; ++k) {
+                ++edgeUse[edgeKey(triangles[i + k], triangles[i + (k + 1) % 3])];
+            }
+        }
+        for (const auto& edge : edgeUse) {
+            unsigned int a = static_cast<unsigned int>(edge.first >> 32);
+            unsigned int b = static_cast<unsigned int>(edge.first & 0xFFFFFFFFu);
+            if (edge.second > 2) {
+                kinds[a] = kinds[b] = VERTEX_LOCKED;
+            } else if (edge.second == 1) {
+                if (kinds[a] != VERTEX_LOCKED) kinds[a] = VERTEX_BORDER;
+                if (kinds[b] != VERTEX_LOCKED) kinds[b] = VERTEX_BORDER;
+            }
+        }
+
+        // Referenced vertices sharing a position belong to an attribute seam
+        std::vector<unsigned int> order;
+        for (size_t v = 0; v < vertexCount; ++v) {
+            if (!adjacency[v].empty()) order.push_back(static_cast<unsigned int>(v));
+        }
+        auto lessPosition = [&](unsigned int a, unsigned int b) {
+            const Vector3& p = positions[a];
+            const Vector3& q = positions[b];
+            if (p.x != q.x) return p.x < q.x;
+            if (p.y != q.y) return p.y < q.y;
+            return p.z < q.z;
+        };
+        std::sort(order.begin(), order.end(), lessPosition);
+        for (size_t i = 1; i < order.size(); ++i) {
+            if (!lessPosition(order[i - 1], order[i])) {
+                kinds[order[i - 1]] = kinds[order[i]] = VERTEX_LOCKED;
+            }
+        }
+    }
+
+    void buildQuadrics() {
+        quadrics.assign(vertexCount, Quadric());
+
+        for (size_t i = 0; i < triangles.size(); i += 3) {
+            const Vector3& p0 = positions[triangles[i]];
+            const Vector3& p1 = positions[triangles[i + 1]];
+            const Vector3& p2 = positions[triangles[i + 2]];
+
+            Vector3 cross = (p1 - p0).cross(p2 - p0);
+            float length = cross.length();
+            if (length <= 0.0f) continue;
+            Vector3 normal = cross * (1.0f / length);
+            double area = 0.5 * length;
+            double d = -normal.dot(p0);
+
+            for (int k = 0; k < 3; ++k) {
+                quadrics[triangles[i + k]].addPlane(normal.x, normal.y, normal.z, d, area);
+            }
+
+            // Planes through border edges, perpendicular to the surface
+            for (int k = 0; k < 3; ++k) {
+                unsigned int a = triangles[i + k];
+                unsigned int b = triangles[i + (k + 1) % 3];
+                if (countSharedTriangles(a, b) != 1) continue;
+
+                Vector3 edge = positions[b] - positions[a];
+                Vector3 borderNormal = edge.cross(normal);
+                float borderLength = borderNormal.length();
+                if (borderLength <= 0.0f) continue;
+                borderNormal = borderNormal * (1.0f / borderLength);
+                double borderD = -borderNormal.dot(positions[a]);
+                double weight = BORDER_WEIGHT * edge.dot(edge);
+                quadrics[a].addPlane(borderNormal.x, borderNormal.y, borderNormal.z, borderD, weight);
+                quadrics[b].addPlane(borderNormal.x, borderNormal.y, borderNormal.z, borderD, weight);
+            }
+        }
+    }
+
+    bool containsVertex(unsigned int triangle, unsigned int vertex) const {
+        const unsigned int* t = &triangles[triangle * 3];
+        return t[0] == vertex || t[1] == vertex || t[2] == vertex;
+    }
+
+    unsigned int countSharedTriangles(unsigned int a, unsigned int b) const {
+        unsigned int count = 0;
+        for (unsigned int t : adjacency[a]) {
+            if (triangleAlive[t] && containsVertex(t, b)) ++count;
+        }
+        return count;
+    }
+
+    // Live neighbours of a vertex (may repeat)
+    void gatherNeighbours(unsigned int vertex, std::vector<unsigned int>& neighbours) const {
+        neighbours.clear();
+        for (unsigned int t : adjacency[vertex]) {
+            if (!triangleAlive[t]) continue;
+            for (int k = 0; k < 3; ++k) {
+                unsigned int other = triangles[t * 3 + k];
+                if (other != vertex) neighbours.push_back(other);
+            }
+        }
+        std::sort(neighbours.begin(), neighbours.end());
+        neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+    }
+
+    void pushBestCollapse(unsigned int from) {
+        if (kinds[from] == VERTEX_LOCKED || !vertexAlive[from]) return;
+
+        gatherNeighbours(from, neighbourScratch);
+        Collapse best = { 0.0, from, NO_VERTEX, versions[from] };
+        for (unsigned int to : neighbourScratch) {
+            // Border vertices only move along a border edge
+            if (kinds[from] == VERTEX_BORDER && countSharedTriangles(from, to) != 1) continue;
+
+            double cost = getCollapseCost(quadrics[from], quadrics[to], positions[to]);
+            if (best.to == NO_VERTEX || cost < best.cost) {
+                best.cost = cost;
+                best.to = to;
+            }
+        }
+        if (best.to != NO_VERTEX) queue.push(best);
+    }
+
+    bool isCollapseValid(unsigned int from, unsigned int to) {
+        // Link condition: the two vertices may only share the neighbours of the
+        // triangles on their common edge, or the collapse would pinch the surface
+        std::vector<unsigned int> fromNeighbours;
+        gatherNeighbours(from, fromNeighbours);
+        gatherNeighbours(to, neighbourScratch);
+        std::vector<unsigned int> common;
+        std::set_intersection(fromNeighbours.begin(), fromNeighbours.end(),
+                              neighbourScratch.begin(), neighbourScratch.end(), std::back_inserter(common));
+        if (common.size() != countSharedTriangles(from, to)) return false;
+
+        // Triangles that stay must not flip or degenerate
+        for (unsigned int t : adjacency[from]) {
+            if (!triangleAlive[t] || containsVertex(t, to)) continue;
+
+            Vector3 p[3];
+            Vector3 moved[3];
+            for (int k = 0; k < 3; ++k) {
+                unsigned int v = triangles[t * 3 + k];
+                p[k] = positions[v];
+                moved[k] = positions[v == from ? to : v];
+            }
+            Vector3 before = (p[1] - p[0]).cross(p[2] - p[0]);
+            Vector3 after = (moved[1] - moved[0]).cross(moved[2] - moved[0]);
+            if (before.dot(after) <= MIN_NORMAL_COSINE * before.length() * after.length()) return false;
+        }
+        return true;
+    }
+
+    void performCollapse(unsigned int from, unsigned int to) {
+        quadrics[to].add(quadrics[from]);
+
+        for (unsigned int t : adjacency[from]) {
+            if (!triangleAlive[t]) continue;
+            if (containsVertex(t, to)) {
+                triangleAlive[t] = false;
+                --liveTriangleCount;
+                continue;
+            }
+            for (int k = 0; k < 3; ++k) {
+                if (triangles[t * 3 + k] == from) triangles[t * 3 + k] = to;
+            }
+            adjacency[to].push_back(t);
+        }
+        adjacency[from].clear();
+        vertexAlive[from] = false;
+
+        // Drop dead triangles from the survivor, then re-evaluate everything
+        // whose best collapse may have changed
+        std::vector<unsigned int>& list = adjacency[to];
+        list.erase(std::remove_if(list.begin(), list.end(), [&](unsigned int t) { return !triangleAlive[t]; }),
+                   list.end());
+
+        std::vector<unsigned int> affected;
+        gatherNeighbours(to, affected);
+        affected.push_back(to);
+        for (unsigned int v : affected) {
+            ++versions[v];
+            pushBestCollapse(v);
+        }
+    }
+
+    size_t vertexCount;
+    std::vector<unsigned int> triangles;
+    std::vector<bool> triangleAlive;
+    size_t liveTriangleCount;
+
+    std::vector<Vector3> positions;
+    std::vector<std::vector<unsigned int>> adjacency;   // Triangles per vertex (may hold dead ones)
+    std::vector<VertexKind> kinds;
+    std::vector<Quadric> quadrics;
+    std::vector<unsigned int> versions;
+    std::vector<bool> vertexAlive;
+
+    std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> queue;
+    std::vector<unsigned int> neighbourScratch;
+};
+
+} // namespace
+
+std::vector<unsigned int> MeshSimplifier::simplify(const Mesh& mesh, const unsigned int* indices, size_t indexCount,
+                                                   size_t targetIndexCount, float maxError, float* resultError) {
+    Simplifier simplifier(mesh, indices, indexCount);
+    return simplifier.run(targetIndexCount, maxError, resultError);
+}
+
+size_t MeshSimplifier::generateLODs(Mesh& mesh, size_t maxLevels, float reduction, float maxError) {
+    TRACE_SCOPE("MeshSimplifier::generateLODs");
+    MeshData& data = mesh.editGeometry();
+    data.makeGeometryOwned();
+    data.clearLODs();
+
+    // Each level is simplified from the previous one, so the levels are nested
+    // and their errors add up
+    std::vector<MeshLOD> levels;
+    const std::vector<unsigned int>* previous = &data.indices;
+    float previousError = 0.0f;
+    while (levels.size() < maxLevels && previousError < maxError) {
+        size_t previousCount = previous->size();
+        size_t target = static_cast<size_t>(previousCount / 3 * reduction) * 3;
+        if (target / 3 < MIN_LOD_TRIANGLES) break;
+
+        float error = 0.0f;
+        std::vector<unsigned int> simplified = simplify(mesh, previous->data(), previousCount, target,
+                                                        maxError - previousError, &error);
+        if (simplified.size() > previousCount * MIN_LOD_PROGRESS) break;
+
+        MeshLOD level;
+        level.indices = std::move(simplified);
+        level.error = previousError + error;
+        previousError = level.error;
+        levels.push_back(std::move(level));
+        previous = &levels.back().indices;
+    }
+    if (levels.empty()) return 0;
+
+    // Renumber vertices coarsest level first, so each level uses a prefix
+    std::vector<Vertex>& vertices = data.vertices;
+    std::vector<unsigned int> remap(vertices.size(), NO_VERTEX);
+    std::vector<Vertex> reordered;
+    reordered.reserve(vertices.size());
+    auto assign = [&](const std::vector<unsigned int>& indices) {
+        for (unsigned int index : indices) {
+            if (remap[index] != NO_VERTEX) continue;
+            remap[index] = static_cast<unsigned int>(reordered.size());
+            reordered.push_back(vertices[index]);
+        }
+    };
+    for (size_t level = levels.size(); level-- > 0;) {
+        assign(levels[level].indices);
+        levels[level].vertexCount = reordered.size();
+    }
+    assign(data.indices);
+    for (size_t v = 0; v < vertices.size(); ++v) {
+        // Unreferenced vertices go last
+        if (remap[v] == NO_VERTEX) {
+            remap[v] = static_cast<unsigned int>(reordered.size());
+            reordered.push_back(vertices[v]);
+        }
+    }
+
+    for (unsigned int& index : data.indices) index = remap[index];
+    for (MeshLOD& level : levels) {
+        for (unsigned int& index : level.indices) index = remap[index];
+    }
+    vertices = std::move(reordered);
+    data.updatePositionStream();
+
+    size_t levelCount = levels.size();
+    data.setLODs(std::move(levels));
+    return levelCount;
+}
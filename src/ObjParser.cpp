@@ -0,0 +1,450 @@
+#include "ObjParser.hpp"
+#include "MappedFile.hpp"
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+namespace {
+
+const long long NO_INDEX = std::numeric_limits<long long>::min();
+const unsigned int NO_VERTEX = std::numeric_limits<unsigned int>::max();
+
+// Set in a face size when the face was rejected while resolving its indices
+const unsigned int REJECTED_FACE = 0x80000000u;
+const unsigned int FACE_SIZE_MASK = ~REJECTED_FACE;
+
+enum Component { POSITION = 0, TEXCOORD = 1, NORMAL = 2 };
+
+// Face corner as written in the file. Negative OBJ indices count back from the
+// records seen so far, so they are stored relative to the start of the chunk
+// until the chunk's global offsets are known.
+struct RawCorner {
+    long long index[3];         // Zero-based, NO_INDEX when the component is absent
+    unsigned char relative;     // Bit c set when index[c] is chunk-relative
+};
+
+struct ResolvedCorner {
+    unsigned int index[3];      // Global zero-based indices, NO_VERTEX when absent
+};
+
+// One line-aligned slice of the file and everything parsed from it
+struct Chunk {
+    const char* begin = nullptr;
+    const char* end = nullptr;
+
+    std::vector<float> positions;   // x, y, z per record
+    std::vector<float> texCoords;   // u, v per record
+    std::vector<float> normals;     // x, y, z per record
+    std::vector<RawCorner> corners;
+    std::vector<unsigned int> faceSizes;    // Corner count, possibly tagged REJECTED_FACE
+    size_t faceCount = 0;
+    size_t skippedFaces = 0;
+
+    // Filled by the merge
+    size_t recordOffset[3] = { 0, 0, 0 };   // Records of each kind in earlier chunks
+    size_t cornerOffset = 0;
+    size_t triangleOffset = 0;
+    size_t triangleCount = 0;
+    bool usesTexCoords = false;
+    bool usesNormals = false;
+
+    size_t getRecordCount(int component) const {
+        switch (component) {
+            case POSITION: return positions.size() / 3;
+            case TEXCOORD: return texCoords.size() / 2;
+            default:       return normals.size() / 3;
+        }
+    }
+};
+
+inline bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline const char* skipBlanks(const char* p, const char* end) {
+    while (p < end && isBlank(*p)) ++p;
+    return p;
+}
+
+// Missing or malformed values read as 0, like the stream-based loader did
+inline float parseFloat(const char*& p, const char* end) {
+    p = skipBlanks(p, end);
+    if (p < end && *p == '+') ++p;      // from_chars does not accept an explicit plus sign
+
+    float value = 0.0f;
+    std::from_chars_result result = std::from_chars(p, end, value);
+    if (result.ptr != p) {
+        p = result.ptr;
+    }
+    return result.ec == std::errc() ? value : 0.0f;
+}
+
+// Parse a one-based (or negative, relative) OBJ index; 0 and garbage are rejected
+inline bool parseIndex(const char*& p, const char* end, size_t recordCount, RawCorner& corner, int component) {
+    long long value = 0;
+    std::from_chars_result result = std::from_chars(p, end, value);
+    if (result.ec != std::errc() || value == 0) return false;
+    p = result.ptr;
+
+    if (value > 0) {
+        corner.index[component] = value - 1;
+    } else {
+        corner.index[component] = static_cast<long long>(recordCount) + value;
+        corner.relative |= static_cast<unsigned char>(1 << component);
+    }
+    return true;
+}
+
+void parseFace(const char* p, const char* end, Chunk& chunk) {
+    ++chunk.faceCount;
+    size_t first = chunk.corners.size();
+    unsigned int cornerCount = 0;
+    bool valid = true;
+
+    for (;;) {
+        p = skipBlanks(p, end);
+        if (p == end || *p == '#') break;
+
+        RawCorner corner;
+        corner.index[POSITION] = NO_INDEX;
+        corner.index[TEXCOORD] = NO_INDEX;
+        corner.index[NORMAL] = NO_INDEX;
+        corner.relative = 0;
+
+        // v, v/vt, v//vn or v/vt/vn
+        valid = parseIndex(p, end, chunk.getRecordCount(POSITION), corner, POSITION);
+        if (valid && p < end && *p == '/') {
+            ++p;
+            if (p < end && *p != '/' && !isBlank(*p)) {
+                valid = parseIndex(p, end, chunk.getRecordCount(TEXCOORD), corner, TEXCOORD);
+            }
+            if (valid && p < end && *p == '/') {
+                ++p;
+                valid = parseIndex(p, end, chunk.getRecordCount(NORMAL), corner, NORMAL);
+            }
+        }
+        if (!valid || (p < end && !isBlank(*p))) {
+            valid = false;
+            break;
+        }
+
+        chunk.corners.push_back(corner);
+        ++cornerCount;
+    }
+
+    if (!valid || cornerCount < 3) {
+        chunk.corners.resize(first);
+        ++chunk.skippedFaces;
+        return;
+    }
+    chunk.faceSizes.push_back(cornerCount);
+}
+
+void parseChunk(Chunk& chunk) {
+    const char* line = chunk.begin;
+    while (line < chunk.end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(line, '\n', chunk.end - line));
+        if (!lineEnd) lineEnd = chunk.end;
+
+        const char* p = skipBlanks(line, lineEnd);
+        if (lineEnd - p >= 2) {
+            if (p[0] == 'v') {
+                if (isBlank(p[1])) {
+                    p += 1;
+                    float x = parseFloat(p, lineEnd);
+                    float y = parseFloat(p, lineEnd);
+                    float z = parseFloat(p, lineEnd);
+                    chunk.positions.insert(chunk.positions.end(), { x, y, z });
+                } else if (p[1] == 't' && lineEnd - p >= 3 && isBlank(p[2])) {
+                    p += 2;
+                    float u = parseFloat(p, lineEnd);
+                    float v = parseFloat(p, lineEnd);
+                    chunk.texCoords.insert(chunk.texCoords.end(), { u, v });
+                } else if (p[1] == 'n' && lineEnd - p >= 3 && isBlank(p[2])) {
+                    p += 2;
+                    float x = parseFloat(p, lineEnd);
+                    float y = parseFloat(p, lineEnd);
+                    float z = parseFloat(p, lineEnd);
+                    chunk.normals.insert(chunk.normals.end(), { x, y, z });
+                }
+            } else if (p[0] == 'f' && isBlank(p[1])) {
+                parseFace(p + 1, lineEnd, chunk);
+            }
+        }
+
+        line = lineEnd + 1;
+    }
+}
+
+// Turn the chunk's corners into global indices, rejecting faces that point
+// outside the records of the whole file
+void resolveChunk(Chunk& chunk, const size_t totalRecords[3], ResolvedCorner* resolved) {
+    size_t corner = 0;
+    for (unsigned int& faceSize : chunk.faceSizes) {
+        bool valid = true;
+        for (unsigned int k = 0; k < faceSize; ++k) {
+            const RawCorner& raw = chunk.corners[corner + k];
+            ResolvedCorner& out = resolved[corner + k];
+
+            for (int c = 0; c < 3; ++c) {
+                if (raw.index[c] == NO_INDEX) {
+                    out.index[c] = NO_VERTEX;
+                    continue;
+                }
+                long long index = raw.index[c];
+                if (raw.relative & (1 << c)) {
+                    index += static_cast<long long>(chunk.recordOffset[c]);
+                }
+                if (index < 0 || index >= static_cast<long long>(totalRecords[c])) {
+                    valid = false;
+                }
+                out.index[c] = static_cast<unsigned int>(index);
+            }
+        }
+
+        if (valid) {
+            for (unsigned int k = 0; k < faceSize; ++k) {
+                chunk.usesTexCoords |= resolved[corner + k].index[TEXCOORD] != NO_VERTEX;
+                chunk.usesNormals |= resolved[corner + k].index[NORMAL] != NO_VERTEX;
+            }
+            chunk.triangleCount += faceSize - 2;
+        } else {
+            ++chunk.skippedFaces;
+        }
+
+        corner += faceSize;
+        if (!valid) faceSize |= REJECTED_FACE;  // Keep the corners, but emit no triangles
+    }
+}
+
+// Fan-triangulate the chunk's faces into its slice of the index buffer
+void triangulateChunk(const Chunk& chunk, const unsigned int* cornerVertex, unsigned int* indices) {
+    size_t corner = 0;
+    size_t slot = 0;
+    for (unsigned int faceSize : chunk.faceSizes) {
+        const unsigned int* face = cornerVertex + corner;
+        corner += faceSize & FACE_SIZE_MASK;
+        if (faceSize & REJECTED_FACE) continue;
+
+        for (unsigned int k = 1; k + 1 < faceSize; ++k) {
+            indices[slot++] = face[0];
+            indices[slot++] = face[k];
+            indices[slot++] = face[k + 1];
+        }
+    }
+}
+
+} // namespace
+
+double ObjParseStats::getMegabytesPerSecond() const {
+    return seconds > 0.0 ? bytes / (1024.0 * 1024.0) / seconds : 0.0;
+}
+
+double ObjParseStats::getVerticesPerSecond() const {
+    return seconds > 0.0 ? positions / seconds : 0.0;
+}
+
+ObjParser::ObjParser(size_t threadCount) : threadCount(threadCount) {
+    if (this->threadCount == 0) {
+        this->threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+ObjParser::~ObjParser() = default;
+
+bool ObjParser::parse(const std::string& filename, ObjMeshData& data, ObjParseStats* stats) {
+    auto start = std::chrono::steady_clock::now();
+
+    MappedFile file;
+    if (!file.open(filename)) {
+        return false;
+    }
+
+    bool result = parse(reinterpret_cast<const char*>(file.data()), file.size(), data, stats);
+    if (stats) {
+        // Include the time spent mapping the file
+        stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    return result;
+}
+
+bool ObjParser::parse(const char* text, size_t length, ObjMeshData& data, ObjParseStats* stats) {
+    TRACE_SCOPE("ObjParser::parse");
+    auto start = std::chrono::steady_clock::now();
+    data = ObjMeshData();
+
+    // Split at line breaks into roughly equal chunks
+    size_t chunkCount = std::min(length / MIN_CHUNK_BYTES, threadCount * 4);
+    chunkCount = std::max<size_t>(chunkCount, 1);
+
+    std::vector<Chunk> chunks(chunkCount);
+    const char* textEnd = text + length;
+    const char* chunkBegin = text;
+    for (size_t i = 0; i < chunkCount; ++i) {
+        const char* chunkEnd = textEnd;
+        if (i + 1 < chunkCount) {
+            chunkEnd = std::max(chunkBegin, text + length / chunkCount * (i + 1));
+            const char* newline = static_cast<const char*>(std::memchr(chunkEnd, '\n', textEnd - chunkEnd));
+            chunkEnd = newline ? newline + 1 : textEnd;
+        }
+        chunks[i].begin = chunkBegin;
+        chunks[i].end = chunkEnd;
+        chunkBegin = chunkEnd;
+    }
+
+    auto forEachChunk = [&](const std::function<void(size_t)>& task) {
+        if (chunkCount == 1) {
+            task(0);
+            return;
+        }
+        if (!pool) {
+            pool.reset(new ThreadPool(threadCount));
+        }
+        pool->parallelFor(chunkCount, task);
+    };
+
+    forEachChunk([&](size_t i) {
+        TRACE_SCOPE("ObjParser::parseChunk");
+        parseChunk(chunks[i]);
+    });
+
+    // Global offsets of each chunk's records and corners, in file order
+    size_t totalRecords[3] = { 0, 0, 0 };
+    size_t totalCorners = 0;
+    for (Chunk& chunk : chunks) {
+        for (int c = 0; c < 3; ++c) {
+            chunk.recordOffset[c] = totalRecords[c];
+            totalRecords[c] += chunk.getRecordCount(c);
+        }
+        chunk.cornerOffset = totalCorners;
+        totalCorners += chunk.corners.size();
+    }
+
+    // 32-bit indices
+    if (totalRecords[POSITION] >= NO_VERTEX || totalCorners >= NO_VERTEX) {
+        return false;
+    }
+
+    std::vector<ResolvedCorner> corners(totalCorners);
+    forEachChunk([&](size_t i) {
+        resolveChunk(chunks[i], totalRecords, corners.data() + chunks[i].cornerOffset);
+    });
+
+    size_t triangleCount = 0;
+    for (Chunk& chunk : chunks) {
+        chunk.triangleOffset = triangleCount;
+        triangleCount += chunk.triangleCount;
+        data.hasTexCoords |= chunk.usesTexCoords;
+        data.hasNormals |= chunk.usesNormals;
+    }
+
+    // Map every corner to an output vertex
+    std::vector<unsigned int> cornerVertex(totalCorners);
+    if (!data.hasTexCoords && !data.hasNormals) {
+        // Positions only: the vertex buffer is the position list in file order
+        data.vertices.resize(totalRecords[POSITION]);
+        forEachChunk([&](size_t i) {
+            const Chunk& chunk = chunks[i];
+            Vertex* out = data.vertices.data() + chunk.recordOffset[POSITION];
+            for (size_t v = 0; v < chunk.positions.size() / 3; ++v) {
+                out[v].position = Vector3(chunk.positions[3 * v], chunk.positions[3 * v + 1], chunk.positions[3 * v + 2]);
+            }
+            for (size_t c = 0; c < chunk.corners.size(); ++c) {
+                cornerVertex[chunk.cornerOffset + c] = corners[chunk.cornerOffset + c].index[POSITION];
+            }
+        });
+    } else {
+        // One vertex per distinct (position, texcoord, normal) tuple, in order of
+        // first use. Tuples sharing a position are chained from that position.
+        std::vector<const float*> positionData(totalRecords[POSITION]);
+        std::vector<const float*> texCoordData(totalRecords[TEXCOORD]);
+        std::vector<const float*> normalData(totalRecords[NORMAL]);
+        for (const Chunk& chunk : chunks) {
+            for (size_t r = 0; r < chunk.getRecordCount(POSITION); ++r) positionData[chunk.recordOffset[POSITION] + r] = &chunk.positions[3 * r];
+            for (size_t r = 0; r < chunk.getRecordCount(TEXCOORD); ++r) texCoordData[chunk.recordOffset[TEXCOORD] + r] = &chunk.texCoords[2 * r];
+            for (size_t r = 0; r < chunk.getRecordCount(NORMAL); ++r) normalData[chunk.recordOffset[NORMAL] + r] = &chunk.normals[3 * r];
+        }
+
+        std::vector<unsigned int> firstVertex(totalRecords[POSITION], NO_VERTEX);
+        std::vector<unsigned int> nextVertex;
+        std::vector<ResolvedCorner> vertexKeys;
+
+        for (const Chunk& chunk : chunks) {
+            size_t corner = chunk.cornerOffset;
+            for (unsigned int faceSize : chunk.faceSizes) {
+                // Rejected faces may hold out-of-range indices; they get no vertices
+                if (faceSize & REJECTED_FACE) {
+                    corner += faceSize & FACE_SIZE_MASK;
+                    continue;
+                }
+
+                for (unsigned int k = 0; k < faceSize; ++k, ++corner) {
+                    const ResolvedCorner& key = corners[corner];
+                    unsigned int position = key.index[POSITION];
+
+                    unsigned int vertex = firstVertex[position];
+                    while (vertex != NO_VERTEX &&
+                           (vertexKeys[vertex].index[TEXCOORD] != key.index[TEXCOORD] ||
+                            vertexKeys[vertex].index[NORMAL] != key.index[NORMAL])) {
+                        vertex = nextVertex[vertex];
+                    }
+
+                    if (vertex == NO_VERTEX) {
+                        vertex = static_cast<unsigned int>(vertexKeys.size());
+                        vertexKeys.push_back(key);
+                        nextVertex.push_back(firstVertex[position]);
+                        firstVertex[position] = vertex;
+                    }
+                    cornerVertex[corner] = vertex;
+                }
+            }
+        }
+
+        data.vertices.resize(vertexKeys.size());
+        for (size_t v = 0; v < vertexKeys.size(); ++v) {
+            const ResolvedCorner& key = vertexKeys[v];
+            Vertex& vertex = data.vertices[v];
+
+            const float* p = positionData[key.index[POSITION]];
+            vertex.position = Vector3(p[0], p[1], p[2]);
+            if (key.index[NORMAL] != NO_VERTEX) {
+                const float* n = normalData[key.index[NORMAL]];
+                vertex.normal = Vector3(n[0], n[1], n[2]);
+            }
+            if (key.index[TEXCOORD] != NO_VERTEX) {
+                const float* t = texCoordData[key.index[TEXCOORD]];
+                vertex.u = t[0];
+                vertex.v = t[1];
+            }
+        }
+    }
+
+    data.indices.resize(triangleCount * 3);
+    forEachChunk([&](size_t i) {
+        triangulateChunk(chunks[i], cornerVertex.data() + chunks[i].cornerOffset,
+                         data.indices.data() + chunks[i].triangleOffset * 3);
+    });
+
+    if (stats) {
+        *stats = ObjParseStats();
+        stats->bytes = length;
+        stats->positions = totalRecords[POSITION];
+        stats->texCoords = totalRecords[TEXCOORD];
+        stats->normals = totalRecords[NORMAL];
+        for (const Chunk& chunk : chunks) {
+            stats->faces += chunk.faceCount;
+            stats->skippedFaces += chunk.skippedFaces;
+        }
+        stats->triangles = triangleCount;
+        stats->vertices = data.vertices.size();
+        stats->chunks = chunkCount;
+        stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    return !data.vertices.empty() && !data.indices.empty();
+}
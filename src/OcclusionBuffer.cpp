@@ -0,0 +1,164 @@
+#include "OcclusionBuffer.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// Occluders are covered with the rasterizers' own 28.4 vertex snapping and
+// top-left fill rule (see setupTriangle() in Renderer.cpp), so a triangle marks
+// exactly the pixels it is drawn on, and the pixels along an edge shared by two
+// occluder triangles are marked by one of them.
+static const int SUBPIXEL_SCALE = 16;
+
+// Coverage mask of a cell with every pixel covered
+static const std::uint16_t FULL_COVERAGE = 0xFFFF;
+static_assert(OcclusionBuffer::CELL_SIZE * OcclusionBuffer::CELL_SIZE == 16, "Coverage masks hold 16 pixels");
+
+OcclusionBuffer::OcclusionBuffer(int screenWidth, int screenHeight)
+    : screenWidth(screenWidth), screenHeight(screenHeight)
+{
+    width = (screenWidth + CELL_SIZE - 1) / CELL_SIZE;
+    height = (screenHeight + CELL_SIZE - 1) / CELL_SIZE;
+    depth.resize(width * height);
+    coverage.resize(width * height);
+    coverageDepth.resize(width * height);
+    clear();
+}
+
+void OcclusionBuffer::clear() {
+    std::fill(depth.begin(), depth.end(), FLT_MAX);
+    std::fill(coverageDepth.begin(), coverageDepth.end(), -FLT_MAX);
+    
+    for (int cy = 0; cy < height; ++cy) {
+        for (int cx = 0; cx < width; ++cx) {
+            coverage[cy * width + cx] = offscreenCoverage(cx, cy);
+        }
+    }
+}
+
+std::uint16_t OcclusionBuffer::offscreenCoverage(int cx, int cy) const {
+    // Pixels past the right and bottom screen edges count as covered
+    std::uint16_t mask = 0;
+    for (int bit = 0; bit < CELL_SIZE * CELL_SIZE; ++bit) {
+        int x = cx * CELL_SIZE + bit % CELL_SIZE;
+        int y = cy * CELL_SIZE + bit / CELL_SIZE;
+        if (x >= screenWidth || y >= screenHeight) mask |= 1 << bit;
+    }
+    return mask;
+}
+
+void OcclusionBuffer::rasterizeOccluder(const Vector3& v0, const Vector3& v1, const Vector3& v2) {
+    // Snap to 28.4 fixed point exactly like the rasterizers
+    const float scale = static_cast<float>(SUBPIXEL_SCALE);
+    const Vector3* vertices[3] = { &v0, &v1, &v2 };
+    long long x[3], y[3];
+    for (int i = 0; i < 3; ++i) {
+        x[i] = static_cast<long long>(std::floor(vertices[i]->x * scale + 0.5f));
+        y[i] = static_cast<long long>(std::floor(vertices[i]->y * scale + 0.5f));
+    }
+
+    // Twice the signed area; its sign orients the edge functions
+    long long area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+    if (area == 0) return;
+    long long sign = area > 0 ? 1 : -1;
+
+    // Pixels whose centers lie inside the snapped vertex bounds, restricted to the screen
+    const long long half = SUBPIXEL_SCALE / 2;
+    auto firstPixel = [&](long long a, long long b, long long c) {
+        long long value = std::min({ a, b, c }) - half;
+        return static_cast<int>(std::max<long long>(0, value >= 0 ? (value + SUBPIXEL_SCALE - 1) / SUBPIXEL_SCALE
+                                                                   : -(-value / SUBPIXEL_SCALE)));
+    };
+    auto lastPixel = [&](long long a, long long b, long long c, int limit) {
+        long long value = std::max({ a, b, c }) - half;
+        if (value < 0) return -1;
+        return static_cast<int>(std::min<long long>(limit - 1, value / SUBPIXEL_SCALE));
+    };
+    int minX = firstPixel(x[0], x[1], x[2]);
+    int minY = firstPixel(y[0], y[1], y[2]);
+    int maxX = lastPixel(x[0], x[1], x[2], screenWidth);
+    int maxY = lastPixel(y[0], y[1], y[2], screenHeight);
+    if (minX > maxX || minY > maxY) return;
+
+    // Edge functions at the center of pixel (0, 0) and their steps per pixel,
+    // non-negative inside the triangle after the top-left bias
+    long long edgeOrigin[3], edgeDx[3], edgeDy[3];
+    for (int i = 0; i < 3; ++i) {
+        long long ax = x[(i + 1) % 3], ay = y[(i + 1) % 3];
+        long long bx = x[(i + 2) % 3], by = y[(i + 2) % 3];
+        long long stepX = (ay - by) * sign;
+        long long stepY = (bx - ax) * sign;
+        long long value = ((ax - half) * (by - half) - (bx - half) * (ay - half)) * sign;
+        bool topLeft = stepX > 0 || (stepX == 0 && stepY > 0);
+        edgeOrigin[i] = topLeft ? value : value - 1;
+        edgeDx[i] = stepX * SUBPIXEL_SCALE;
+        edgeDy[i] = stepY * SUBPIXEL_SCALE;
+    }
+
+    // Farthest depth of the triangle: every pixel it covers is at least this near
+    float maxDepth = std::max({v0.z, v1.z, v2.z});
+
+    for (int cy = minY / CELL_SIZE; cy <= maxY / CELL_SIZE; ++cy) {
+        for (int cx = minX / CELL_SIZE; cx <= maxX / CELL_SIZE; ++cx) {
+            int pixelX = cx * CELL_SIZE;
+            int pixelY = cy * CELL_SIZE;
+
+            // Edge functions are linear, so their extremes over the cell's pixel
+            // centers are at its corner pixels
+            bool full = true, empty = false;
+            long long corner[3];
+            for (int i = 0; i < 3; ++i) {
+                corner[i] = edgeOrigin[i] + pixelX * edgeDx[i] + pixelY * edgeDy[i];
+                long long reach = (CELL_SIZE - 1) * edgeDx[i], reachY = (CELL_SIZE - 1) * edgeDy[i];
+                long long minimum = corner[i] + std::min(reach, 0LL) + std::min(reachY, 0LL);
+                long long maximum = corner[i] + std::max(reach, 0LL) + std::max(reachY, 0LL);
+                full = full && minimum >= 0;
+                empty = empty || maximum < 0;
+            }
+            if (empty) continue;
+
+            size_t cell = cy * width + cx;
+            if (full) {
+                depth[cell] = std::min(depth[cell], maxDepth);
+                continue;
+            }
+
+            // Partly covered: add the pixels this triangle covers
+            std::uint16_t mask = 0;
+            for (int bit = 0; bit < CELL_SIZE * CELL_SIZE; ++bit) {
+                long long dx = bit % CELL_SIZE, dy = bit / CELL_SIZE;
+                bool inside = true;
+                for (int i = 0; i < 3 && inside; ++i) {
+                    inside = corner[i] + dx * edgeDx[i] + dy * edgeDy[i] >= 0;
+                }
+                if (inside) mask |= 1 << bit;
+            }
+            if (mask == 0) continue;
+
+            // Once every pixel is covered, the farthest of the covering triangles bounds the cell
+            coverage[cell] |= mask;
+            coverageDepth[cell] = std::max(coverageDepth[cell], maxDepth);
+            if (coverage[cell] == FULL_COVERAGE) {
+                depth[cell] = std::min(depth[cell], coverageDepth[cell]);
+                coverage[cell] = offscreenCoverage(cx, cy);
+                coverageDepth[cell] = -FLT_MAX;
+            }
+        }
+    }
+}
+
+bool OcclusionBuffer::isRectOccluded(float minX, float minY, float maxX, float maxY, float minDepth) const {
+    // Pad by a pixel to cover the rasterizers' snapping of vertex positions
+    int cellMinX = std::max(0, static_cast<int>(std::floor((minX - 1.0f) / CELL_SIZE)));
+    int cellMaxX = std::min(width - 1, static_cast<int>(std::floor((maxX + 1.0f) / CELL_SIZE)));
+    int cellMinY = std::max(0, static_cast<int>(std::floor((minY - 1.0f) / CELL_SIZE)));
+    int cellMaxY = std::min(height - 1, static_cast<int>(std::floor((maxY + 1.0f) / CELL_SIZE)));
+    if (cellMinX > cellMaxX || cellMinY > cellMaxY) return false;
+
+    for (int cy = cellMinY; cy <= cellMaxY; ++cy) {
+        const float* row = &depth[cy * width];
+        for (int cx = cellMinX; cx <= cellMaxX; ++cx) {
+            if (row[cx] >= minDepth) return false;
+        }
+    }
+    return true;
+}
@@ -1,42 +1,470 @@
 #include "Renderer.hpp"
 // #include "Light.hpp"
 #include "Material.hpp"
+#include "Trace.hpp"
+#ifndef HEADLESS
 #include <SFML/Graphics.hpp>
+#endif
 #include <algorithm>
+#include <fstream>
 #include <limits>
+#include <utility>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
 #include <cmath>
 
+namespace {
+
+// Polygon vertex during clipping, with the attributes interpolated along clipped edges
+struct ClipVertex {
+    Vector4 position;   // Clip space
+    float r, g, b;      // Vertex color (unused by flat shading)
+    float u, v;         // Texture coordinates (textured triangles only)
+};
+
+// A triangle gains at most one vertex per clip plane (near + 4 guard-band planes)
+const int MAX_CLIP_VERTICES = 8;
+
+ClipVertex makeClipVertex(const Vector4& position, const LinearColor& color, float u = 0.0f, float v = 0.0f) {
+    return ClipVertex{ position, color.r, color.g, color.b, u, v };
+}
+
+// Sutherland-Hodgman step against the plane a*x + b*y + c*z + d*w >= 0
+int clipAgainstPlane(const ClipVertex* in, int count, ClipVertex* out, float a, float b, float c, float d) {
+    int outCount = 0;
+    for (int i = 0; i < count; ++i) {
+        const ClipVertex& current = in[i];
+        const ClipVertex& next = in[(i + 1) % count];
+        float currentDistance = a * current.position.x + b * current.position.y + c * current.position.z + d * current.position.w;
+        float nextDistance = a * next.position.x + b * next.position.y + c * next.position.z + d * next.position.w;
+        
+        if (currentDistance >= 0.0f) {
+            out[outCount++] = current;
+        }
+        if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f)) {
+            // Edge crosses the plane: emit the intersection
+            float t = currentDistance / (currentDistance - nextDistance);
+            ClipVertex& v = out[outCount++];
+            v.position = current.position + (next.position - current.position) * t;
+            v.r = current.r + (next.r - current.r) * t;
+            v.g = current.g + (next.g - current.g) * t;
+            v.b = current.b + (next.b - current.b) * t;
+            v.u = current.u + (next.u - current.u) * t;
+            v.v = current.v + (next.v - current.v) * t;
+        }
+    }
+    return outCount;
+}
+
+// Clip a triangle against the near plane and the guard band; returns the vertex count
+// of the resulting convex polygon (0 if nothing is left)
+int clipTriangle(ClipVertex* polygon, float guardBandX, float guardBandY) {
+    ClipVertex scratch[MAX_CLIP_VERTICES];
+    int count = clipAgainstPlane(polygon, 3, scratch, 0.0f, 0.0f, 1.0f, 1.0f);       // z >= -w
+    count = clipAgainstPlane(scratch, count, polygon, 1.0f, 0.0f, 0.0f, guardBandX);   // x >= -gx * w
+    count = clipAgainstPlane(polygon, count, scratch, -1.0f, 0.0f, 0.0f, guardBandX);  // x <= gx * w
+    count = clipAgainstPlane(scratch, count, polygon, 0.0f, 1.0f, 0.0f, guardBandY);   // y >= -gy * w
+    count = clipAgainstPlane(polygon, count, scratch, 0.0f, -1.0f, 0.0f, guardBandY);  // y <= gy * w
+    
+    for (int i = 0; i < count; ++i) {
+        polygon[i] = scratch[i];
+    }
+    return count;
+}
+
+// Floats of the position stream covering the first `count` vertices, in whole SIMD blocks
+size_t getPaddedCount(size_t count, const PositionStreamView& stream) {
+    size_t padded = (count + PositionStream::PADDING - 1) / PositionStream::PADDING * PositionStream::PADDING;
+    return std::min(padded, stream.paddedCount);
+}
+
+// Projected level-of-detail error allowed by default, in pixels
+const float DEFAULT_LOD_PIXEL_ERROR = 1.0f;
+
+// A mesh only switches to a coarser level once that level's projected error is
+// this fraction below the limit, so it does not flicker around the threshold
+const float LOD_HYSTERESIS = 0.25f;
+
+// Ends a vertex's list of lit color entries
+const unsigned int NO_LIT_ENTRY = ~0u;
+
+// Corners of a vertex share one lit color when their unit normals differ by at
+// most this much per component. Face normals of coplanar triangles only differ
+// by rounding, so flat regions light each vertex once.
+const float NORMAL_MATCH_TOLERANCE = 1e-5f;
+
+// Maps object-space face normals to world space. Uses the cofactor matrix of the
+// upper 3x3 (det(M) * M^-T), for which cross(M a, M b) = N cross(a, b), so the
+// result points the same way as a normal computed from world-space vertices,
+// mirroring transforms included. Vertex normals, which do not follow the
+// winding, need the sign of det(M) applied (see NormalMatrix::mirrors).
+struct NormalMatrix {
+    float m[3][3];
+    bool preservesLength;   // Rotation (and uniform scale): unit normals stay unit length
+    bool mirrors;           // Negative determinant: flips winding, so vertex normals must be negated
+    
+    Vector3 multiply(const Vector3& n) const {
+        return Vector3(m[0][0] * n.x + m[0][1] * n.y + m[0][2] * n.z,
+                       m[1][0] * n.x + m[1][1] * n.y + m[1][2] * n.z,
+                       m[2][0] * n.x + m[2][1] * n.y + m[2][2] * n.z);
+    }
+    
+    // Face normal of a triangle from the face normal of its object-space triangle
+    Vector3 transform(const Vector3& n) const {
+        Vector3 result = multiply(n);
+        return preservesLength ? result : result.normalized();
+    }
+};
+
+NormalMatrix makeNormalMatrix(const Matrix4& world) {
+    // Columns of the upper 3x3; the cofactor columns are their pairwise cross products
+    Vector3 a(world.m[0][0], world.m[1][0], world.m[2][0]);
+    Vector3 b(world.m[0][1], world.m[1][1], world.m[2][1]);
+    Vector3 c(world.m[0][2], world.m[1][2], world.m[2][2]);
+    Vector3 columns[3] = { b.cross(c), c.cross(a), a.cross(b) };
+    
+    // With orthogonal columns of equal length s, the cofactor matrix is s^2 times
+    // a rotation: divide that out and skip the per-normal normalization
+    float aa = a.dot(a), bb = b.dot(b), cc = c.dot(c);
+    float tolerance = 1e-4f * std::max(aa, std::max(bb, cc));
+    NormalMatrix result;
+    result.mirrors = a.dot(columns[0]) < 0.0f;
+    result.preservesLength = aa > 0.0f && std::fabs(aa - bb) <= tolerance && std::fabs(aa - cc) <= tolerance &&
+                             std::fabs(a.dot(b)) <= tolerance && std::fabs(b.dot(c)) <= tolerance &&
+                             std::fabs(c.dot(a)) <= tolerance;
+    float scale = result.preservesLength ? 1.0f / aa : 1.0f;
+    for (int column = 0; column < 3; ++column) {
+        result.m[0][column] = columns[column].x * scale;
+        result.m[1][column] = columns[column].y * scale;
+        result.m[2][column] = columns[column].z * scale;
+    }
+    return result;
+}
+
+// Triangle rasterizers snap vertices to 28.4 fixed point (1/16 pixel) and
+// sample pixels at their centers
+const int SUBPIXEL_BITS = 4;
+const int SUBPIXEL_SCALE = 1 << SUBPIXEL_BITS;
+
+long long floorDivide(long long a, long long b) {   // b > 0
+    return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+// Attribute that varies linearly over the screen: value at the center of a
+// reference pixel, plus its change per pixel step. The reference does not
+// depend on the clip rectangle, so every pixel gets the same value whether the
+// triangle is drawn whole or tile by tile.
+struct AttributePlane {
+    float origin, dx, dy;
+    int referenceX, referenceY;
+    
+    // The SIMD paths evaluate (origin + x term) + y term in this same order
+    float rowTerm(int y) const { return static_cast<float>(y - referenceY) * dy; }
+    float at(int x, int y) const { return origin + static_cast<float>(x - referenceX) * dx + rowTerm(y); }
+};
+
+// Integer triangle setup shared by the triangle rasterizers.
+// Edge functions are exact in fixed point and biased for the top-left fill
+// rule: a pixel is covered when all three are >= 0, so a pixel center lying
+// exactly on an edge shared by two triangles is drawn by one of them, never
+// both or neither. Attributes are interpolated with their own float planes;
+// the edge values are only used for coverage.
+struct TriangleSetup {
+    int minX, minY, maxX, maxY;     // Pixel bounding box, restricted to the clip rectangle
+    long long edgeOrigin[3];        // Edge values at the center of pixel (minX, minY); edge i is opposite vertex i
+    int edgeDx[3], edgeDy[3];       // Per-pixel steps (16 times the 28.4 deltas)
+    
+    // Plane equation inputs: 28.4 vertex deltas from v0, the reciprocal of twice
+    // the signed area, and the reference pixel (the unclipped bounding box corner)
+    long long dx1, dy1, dx2, dy2;
+    double invArea;
+    int referenceX, referenceY;
+    long long referenceOffsetX, referenceOffsetY;   // From v0 to the reference pixel's center
+    
+    AttributePlane makePlane(float a0, float a1, float a2) const {
+        double d1 = static_cast<double>(a1) - a0;
+        double d2 = static_cast<double>(a2) - a0;
+        double gradientX = (d1 * dy2 - d2 * dy1) * invArea;     // Per 1/16 pixel
+        double gradientY = (d2 * dx1 - d1 * dx2) * invArea;
+        return AttributePlane{ static_cast<float>(a0 + gradientX * referenceOffsetX + gradientY * referenceOffsetY),
+                               static_cast<float>(gradientX * SUBPIXEL_SCALE),
+                               static_cast<float>(gradientY * SUBPIXEL_SCALE), referenceX, referenceY };
+    }
+};
+
+// False when the triangle's bounding box holds no pixel center of the clip rectangle,
+// or has no area after snapping. With alignment 2 the box starts on even pixels.
+bool setupTriangle(const Vector3& v0, const Vector3& v1, const Vector3& v2, int clipMinX, int clipMinY,
+                   int clipMaxX, int clipMaxY, TriangleSetup& setup, int alignment = 1) {
+    // Snap to 28.4 fixed point (the guard band keeps coordinates far inside the int range)
+    const float scale = static_cast<float>(SUBPIXEL_SCALE);
+    long long x0 = static_cast<long long>(std::floor(v0.x * scale + 0.5f));
+    long long y0 = static_cast<long long>(std::floor(v0.y * scale + 0.5f));
+    long long x1 = static_cast<long long>(std::floor(v1.x * scale + 0.5f));
+    long long y1 = static_cast<long long>(std::floor(v1.y * scale + 0.5f));
+    long long x2 = static_cast<long long>(std::floor(v2.x * scale + 0.5f));
+    long long y2 = static_cast<long long>(std::floor(v2.y * scale + 0.5f));
+    
+    // Pixels whose centers (16 * x + 8 in 28.4) lie inside the vertex bounds
+    const long long half = SUBPIXEL_SCALE / 2;
+    setup.referenceX = static_cast<int>(floorDivide(std::min({x0, x1, x2}) - half + SUBPIXEL_SCALE - 1, SUBPIXEL_SCALE));
+    setup.referenceY = static_cast<int>(floorDivide(std::min({y0, y1, y2}) - half + SUBPIXEL_SCALE - 1, SUBPIXEL_SCALE));
+    setup.minX = std::max(clipMinX, setup.referenceX);
+    setup.maxX = std::min(clipMaxX, static_cast<int>(floorDivide(std::max({x0, x1, x2}) - half, SUBPIXEL_SCALE)));
+    setup.minY = std::max(clipMinY, setup.referenceY);
+    setup.maxY = std::min(clipMaxY, static_cast<int>(floorDivide(std::max({y0, y1, y2}) - half, SUBPIXEL_SCALE)));
+    if (setup.minX > setup.maxX || setup.minY > setup.maxY) return false;
+    setup.minX -= setup.minX & (alignment - 1);
+    setup.minY -= setup.minY & (alignment - 1);
+    
+    // Twice the signed triangle area
+    setup.dx1 = x1 - x0; setup.dy1 = y1 - y0;
+    setup.dx2 = x2 - x0; setup.dy2 = y2 - y0;
+    long long area = setup.dx1 * setup.dy2 - setup.dx2 * setup.dy1;
+    if (area == 0) return false;
+    setup.invArea = 1.0 / static_cast<double>(area);
+    
+    setup.referenceOffsetX = setup.referenceX * static_cast<long long>(SUBPIXEL_SCALE) + half - x0;
+    setup.referenceOffsetY = setup.referenceY * static_cast<long long>(SUBPIXEL_SCALE) + half - y0;
+    long long centerX = setup.minX * static_cast<long long>(SUBPIXEL_SCALE) + half;
+    long long centerY = setup.minY * static_cast<long long>(SUBPIXEL_SCALE) + half;
+    
+    // Edge i runs between the other two vertices; oriented so that the inside is >= 0
+    const long long edgeX[3][2] = { { x1, x2 }, { x2, x0 }, { x0, x1 } };
+    const long long edgeY[3][2] = { { y1, y2 }, { y2, y0 }, { y0, y1 } };
+    long long sign = area > 0 ? 1 : -1;
+    for (int i = 0; i < 3; ++i) {
+        long long ax = edgeX[i][0], bx = edgeX[i][1];
+        long long ay = edgeY[i][0], by = edgeY[i][1];
+        long long stepX = (ay - by) * sign;   // Change per 1/16 pixel in x
+        long long stepY = (bx - ax) * sign;
+        long long value = ((ax - centerX) * (by - centerY) - (bx - centerX) * (ay - centerY)) * sign;
+        
+        // Top-left rule: pixel centers exactly on an edge are inside only for left
+        // edges (inside to their right) and top edges (horizontal, inside below)
+        bool topLeft = stepX > 0 || (stepX == 0 && stepY > 0);
+        setup.edgeOrigin[i] = topLeft ? value : value - 1;
+        setup.edgeDx[i] = static_cast<int>(stepX * SUBPIXEL_SCALE);
+        setup.edgeDy[i] = static_cast<int>(stepY * SUBPIXEL_SCALE);
+    }
+    return true;
+}
+
+// Calls shadeBlock(blockX, blockY, blockMaxX, blockMaxY, e0, e1, e2) for each
+// 8x8 block of the setup's bounding box that may hold covered pixels (blocks
+// start at minX, minY). The edge values are those at the block's first pixel.
+// They are exact for coverage but rebased so every value inside the block fits
+// in 32 bits: an edge the whole block is inside of is shifted down to 0.
+template <typename ShadeBlock>
+void forEachBlock(const TriangleSetup& setup, ShadeBlock shadeBlock) {
+    const int BLOCK_SIZE = 8;
+    for (int blockY = setup.minY; blockY <= setup.maxY; blockY += BLOCK_SIZE) {
+        int blockMaxY = std::min(blockY + BLOCK_SIZE - 1, setup.maxY);
+        int blockHeight = blockMaxY - blockY;
+        
+        for (int blockX = setup.minX; blockX <= setup.maxX; blockX += BLOCK_SIZE) {
+            int blockMaxX = std::min(blockX + BLOCK_SIZE - 1, setup.maxX);
+            int blockWidth = blockMaxX - blockX;
+            
+            // Edge functions are linear, so their extremes over a block are at its corners
+            int corner[3];
+            bool outside = false;
+            for (int i = 0; i < 3 && !outside; ++i) {
+                long long dx = setup.edgeDx[i], dy = setup.edgeDy[i];
+                long long value = setup.edgeOrigin[i] + (blockX - setup.minX) * dx + (blockY - setup.minY) * dy;
+                long long maximum = value + std::max(dx, 0LL) * blockWidth + std::max(dy, 0LL) * blockHeight;
+                long long minimum = value + std::min(dx, 0LL) * blockWidth + std::min(dy, 0LL) * blockHeight;
+                outside = maximum < 0;
+                corner[i] = static_cast<int>(minimum >= 0 ? value - minimum : value);
+            }
+            if (outside) continue; // Block entirely outside
+            
+            shadeBlock(blockX, blockY, blockMaxX, blockMaxY, corner[0], corner[1], corner[2]);
+        }
+    }
+}
+
+} // namespace
+
 Renderer::Renderer(int width, int height) 
-    : screenWidth(width), screenHeight(height)
+    : screenWidth(width), screenHeight(height),
+      colorBuffer(width, height), pixels(colorBuffer.getPixelCount(), 0xFF000000u),
+      occlusionBuffer(width, height), occlusionCulling(false),
+      lodPixelError(DEFAULT_LOD_PIXEL_ERROR)
 {
-    // Initialize frame buffer
-    frameBuffer.resize(screenWidth * screenHeight, Color(0, 0, 0));
+    // Guard band in NDC units: GUARD_BAND_PIXELS beyond each screen edge
+    guardBandX = 1.0f + 2.0f * GUARD_BAND_PIXELS / screenWidth;
+    guardBandY = 1.0f + 2.0f * GUARD_BAND_PIXELS / screenHeight;
     
     // Initialize depth buffer
     initZBuffer();
     
-    // Initialize minimal SFML objects for display
-    displayImage = new sf::Image(sf::Vector2u(screenWidth, screenHeight), sf::Color::Black);
+    // Split the screen into tiles and start one raster worker per core
+    initTiles();
+    threadPool = std::make_unique<ThreadPool>();
+    
+#ifndef HEADLESS
+    // Display texture and sprite are created once; present() updates the texture in place
+    displayTexture = std::make_unique<sf::Texture>();
+    if (!displayTexture->resize(sf::Vector2u(screenWidth, screenHeight))) {
+        printf("ERROR: Failed to create %dx%d display texture!\n", screenWidth, screenHeight);
+    }
+    displaySprite = std::make_unique<sf::Sprite>(*displayTexture);
+#endif
     
     printf("Renderer initialized: %dx%d\n", screenWidth, screenHeight);
 }
 
-Renderer::~Renderer() {
-    delete displayImage;
-}
+// Out of line: the display objects are incomplete types in the header
+Renderer::~Renderer() = default;
 
 void Renderer::clear(const Color& clearColor) {
+    // Each clear starts a new frame
+#if FRAME_STATS
+    unsigned long long frame = frameStats.frame + 1;
+    frameStats = FrameStats();
+    frameStats.frame = frame;
+    frameStats.screenPixels = colorBuffer.getPixelCount();
+#endif
+    StageTimer timer(frameStats.clearMs);
+    TRACE_SCOPE("Renderer::clear");
+    
     // Clear frame buffer
-    std::fill(frameBuffer.begin(), frameBuffer.end(), clearColor);
+    colorBuffer.clear(LinearColor(clearColor));
     
     // Clear depth buffer
     std::fill(zBuffer.begin(), zBuffer.end(), std::numeric_limits<float>::max());
 }
 
 void Renderer::render_Mesh(const std::vector<Mesh>& meshes, const Camera& camera) {
+    // Every mesh is a candidate and gets its own frustum test
+    selectAllMeshes(meshes);
+    Frustum frustum = camera.getFrustum();
+    drawMeshes(camera, &frustum);
+}
+
+void Renderer::render_Mesh(Scene& scene, const Camera& camera) {
+    // The scene hierarchy has already done the frustum tests
+    selectVisibleMeshes(scene, camera);
+    drawMeshes(camera, nullptr);
+}
+
+void Renderer::render_MeshInstanced(const MeshData& geometry, const std::vector<Matrix4>& instanceTransforms,
+                                    const Camera& camera) {
+    selectInstances(geometry, instanceTransforms, nullptr);
+    Frustum frustum = camera.getFrustum();
+    drawMeshes(camera, &frustum);
+}
+
+void Renderer::render_Light(const std::vector<Mesh>& meshes, const Camera& camera, 
+                           const std::vector<Light>& lights, const Material& material) {
+    selectAllMeshes(meshes);
+    Frustum frustum = camera.getFrustum();
+    drawLitMeshes(camera, &frustum, lights, material, false);
+}
+
+void Renderer::render_Light(Scene& scene, const Camera& camera,
+                           const std::vector<Light>& lights, const Material& material) {
+    selectVisibleMeshes(scene, camera);
+    drawLitMeshes(camera, nullptr, lights, material, false);
+}
+
+void Renderer::render_LightInstanced(const MeshData& geometry, const std::vector<Matrix4>& instanceTransforms,
+                                     const Camera& camera, const std::vector<Light>& lights,
+                                     const Material& material, const Texture* texture) {
+    selectInstances(geometry, instanceTransforms, texture);
+    for (std::vector<Vector3>& normals : objectFaceNormals) {
+        normals.clear();
+    }
+    objectFaceNormals.resize(geometry.getLODCount());
+    Frustum frustum = camera.getFrustum();
+    drawLitMeshes(camera, &frustum, lights, material, true);
+}
+
+void Renderer::selectAllMeshes(const std::vector<Mesh>& meshes) {
+    cullStats = CullStats();
+    lightingStats = LightingStats();
+    meshLODLevels.resize(meshes.size(), 0);
+    drawItems.resize(meshes.size());
+    for (size_t i = 0; i < meshes.size(); ++i) {
+        drawItems[i] = DrawItem{ &meshes[i].getGeometry(), meshes[i].getWorldTransformMatrix(), i,
+                                 &meshLODLevels[i], meshes[i].isOccluder(), meshes[i].getTexture() };
+    }
+}
+
+void Renderer::selectVisibleMeshes(Scene& scene, const Camera& camera) {
+    scene.update();
+    visibleMeshIndices.clear();
+    scene.queryFrustum(camera.getFrustum(), visibleMeshIndices);
+    
+    // Account for the meshes the hierarchy rejected without visiting them.
+    // Read-only access: Scene::getMesh() would mark every visible mesh as edited.
+    const std::vector<Mesh>& meshes = scene.getMeshes();
+    size_t visibleTriangles = 0;
+    for (size_t meshIndex : visibleMeshIndices) {
+        visibleTriangles += meshes[meshIndex].getTriangleCount();
+    }
+    cullStats = CullStats();
+    lightingStats = LightingStats();
+    meshLODLevels.resize(scene.getMeshCount(), 0);
+    cullStats.meshesTested = scene.getMeshCount() - visibleMeshIndices.size();
+    cullStats.frustumCulled = cullStats.meshesTested;
+    cullStats.trianglesCulled = scene.getTriangleCount() - visibleTriangles;
+    
+    drawItems.resize(visibleMeshIndices.size());
+    for (size_t i = 0; i < visibleMeshIndices.size(); ++i) {
+        size_t meshIndex = visibleMeshIndices[i];
+        const Mesh& mesh = meshes[meshIndex];
+        drawItems[i] = DrawItem{ &mesh.getGeometry(), mesh.getWorldTransformMatrix(), meshIndex,
+                                 &meshLODLevels[meshIndex], mesh.isOccluder(), mesh.getTexture() };
+    }
+}
+
+void Renderer::selectInstances(const MeshData& geometry, const std::vector<Matrix4>& instanceTransforms,
+                               const Texture* texture) {
+    cullStats = CullStats();
+    lightingStats = LightingStats();
+    
+    // LOD state is kept per geometry, so several instanced calls per frame do not
+    // disturb each other
+    std::vector<unsigned char>& lodLevels = instanceLODLevels[&geometry];
+    lodLevels.resize(instanceTransforms.size(), 0);
+    
+    drawItems.resize(instanceTransforms.size());
+    for (size_t i = 0; i < instanceTransforms.size(); ++i) {
+        drawItems[i] = DrawItem{ &geometry, instanceTransforms[i], i, &lodLevels[i], false, texture };
+    }
+}
+
+const Vector3* Renderer::getObjectFaceNormals(const MeshData& geometry, size_t level) {
+    // Only levels some instance actually draws are computed
+    std::vector<Vector3>& normals = objectFaceNormals[level];
+    size_t triangleCount = geometry.getLODTriangleCount(level);
+    if (normals.size() != triangleCount) {
+        normals.resize(triangleCount);
+        const unsigned int* indexData = geometry.getLODIndexData(level);
+        for (size_t i = 0; i < triangleCount; ++i) {
+            normals[i] = calculateFaceNormal(geometry.getVertexPosition(indexData[i * 3]),
+                                             geometry.getVertexPosition(indexData[i * 3 + 1]),
+                                             geometry.getVertexPosition(indexData[i * 3 + 2]));
+        }
+    }
+    return normals.data();
+}
+
+void Renderer::drawMeshes(const Camera& camera, const Frustum* frustum) {
+    TRACE_SCOPE("Renderer::drawMeshes");
+    StageTimer timer(frameStats.transformMs);
+    
     // Get combined view-projection matrix
     Matrix4 viewProjMatrix = camera.getViewProjectionMatrix();
     
+    // Rasterize occluders before any mesh is submitted
+    if (occlusionCulling) {
+        buildOcclusionBuffer(camera, frustum, viewProjMatrix);
+    }
+    
     // Simple color palette for different meshes
     Color meshColors[] = {
         Color(255, 100, 100),  // Red
@@ -48,194 +476,818 @@ void Renderer::render_Mesh(const std::vector<Mesh>& meshes, const Camera& camera
     };
     
     // Render each mesh
-    for (size_t meshIndex = 0; meshIndex < meshes.size(); ++meshIndex) {
-        const Mesh& mesh = meshes[meshIndex];
-        Color meshColor = meshColors[meshIndex % 6]; // Cycle through colors
+    for (const DrawItem& item : drawItems) {
+        const MeshData& mesh = *item.geometry;
+        LinearColor meshColor(meshColors[item.colorIndex % 6]); // Cycle through colors
         
         // Get mesh transformation matrix
-        Matrix4 worldMatrix = mesh.getWorldTransformMatrix();
+        const Matrix4& worldMatrix = item.worldMatrix;
         Matrix4 mvpMatrix = viewProjMatrix * worldMatrix;
         
-        // Store visible triangles for edge rendering
-        std::vector<std::tuple<Vector3, Vector3, Vector3>> visibleTriangles;
+        // Skip meshes outside the frustum or hidden behind occluders
+        if (cullMesh(mesh, worldMatrix, mvpMatrix, frustum)) continue;
+        
+        // Store edges of visible triangles for edge rendering
+        std::vector<std::pair<Vector3, Vector3>> visibleEdges;
+        
+        // Coarser levels only use a prefix of the vertex buffer
+        size_t lod = selectLOD(item, camera);
+        size_t triangleCount = mesh.getLODTriangleCount(lod);
+        cullStats.lodTrianglesSkipped += mesh.getTriangleCount() - triangleCount;
+        FRAME_STATS_ADD(frameStats.trianglesSubmitted, triangleCount);
+        
+        // Vertex processing: transform each unique vertex once
+        transformVertices(mesh, mvpMatrix, mesh.getLODVertexCount(lod));
         
         // First pass: Render triangle fills
-        for (size_t i = 0; i < mesh.getTriangleCount(); ++i) {
-            Triangle triangle = mesh.getTriangle(i);
-            
-            // Transform vertices to clip space
-            Vector3 v0_clip = mvpMatrix.multiply(triangle.v0.position);
-            Vector3 v1_clip = mvpMatrix.multiply(triangle.v1.position);
-            Vector3 v2_clip = mvpMatrix.multiply(triangle.v2.position);
-            
-            // Perspective division (clip space to NDC)
-            if (v0_clip.z <= 0.0f || v1_clip.z <= 0.0f || v2_clip.z <= 0.0f) continue; // Behind camera
+        const unsigned int* indexData = mesh.getLODIndexData(lod);
+        for (size_t i = 0; i < triangleCount; ++i) {
+            // Triangle assembly from the post-transform cache
+            unsigned int i0 = indexData[i * 3];
+            unsigned int i1 = indexData[i * 3 + 1];
+            unsigned int i2 = indexData[i * 3 + 2];
+            const TransformedVertex& t0 = transformedVertices[i0];
+            const TransformedVertex& t1 = transformedVertices[i1];
+            const TransformedVertex& t2 = transformedVertices[i2];
             
-            Vector3 v0_ndc = Vector3(v0_clip.x / v0_clip.z, v0_clip.y / v0_clip.z, v0_clip.z);
-            Vector3 v1_ndc = Vector3(v1_clip.x / v1_clip.z, v1_clip.y / v1_clip.z, v1_clip.z);
-            Vector3 v2_ndc = Vector3(v2_clip.x / v2_clip.z, v2_clip.y / v2_clip.z, v2_clip.z);
-            
-            // Simple clipping: skip triangles that are completely outside the view volume
-            if (v0_ndc.x < -1.0f && v1_ndc.x < -1.0f && v2_ndc.x < -1.0f) continue; // Left of screen
-            if (v0_ndc.x > 1.0f && v1_ndc.x > 1.0f && v2_ndc.x > 1.0f) continue;   // Right of screen
-            if (v0_ndc.y < -1.0f && v1_ndc.y < -1.0f && v2_ndc.y < -1.0f) continue; // Below screen
-            if (v0_ndc.y > 1.0f && v1_ndc.y > 1.0f && v2_ndc.y > 1.0f) continue;   // Above screen
-            
-            // Transform to screen coordinates
-            Vector3 v0_screen = viewportTransform(v0_ndc);
-            Vector3 v1_screen = viewportTransform(v1_ndc);
-            Vector3 v2_screen = viewportTransform(v2_ndc);
-            
-            // Check if triangle is visible on screen
-            if (!isTriangleVisible(v0_screen, v1_screen, v2_screen)) {
+            // Skip triangles entirely outside one of the view volume planes
+            TriangleTest outcodeTest = testOutcodes(t0.outcode, t1.outcode, t2.outcode);
+            if (outcodeTest != TriangleTest::Visible) {
+                countCulledTriangle(outcodeTest);
                 continue;
             }
             
-            // Back-face culling
-            if (!isBackFace(v0_screen, v1_screen, v2_screen)) {
-                continue;
+            // Project the triangle, clipping it first if it crosses the near plane
+            // or leaves the guard band
+            Vector3 polygon[MAX_CLIP_VERTICES];
+            int vertexCount = 3;
+            if (((t0.outcode | t1.outcode | t2.outcode) & CLIP_REQUIRED) == 0) {
+                polygon[0] = t0.screen;
+                polygon[1] = t1.screen;
+                polygon[2] = t2.screen;
+            } else {
+                ClipVertex clipped[MAX_CLIP_VERTICES] = {
+                    makeClipVertex(t0.clip, meshColor),
+                    makeClipVertex(t1.clip, meshColor),
+                    makeClipVertex(t2.clip, meshColor)
+                };
+                vertexCount = clipTriangle(clipped, guardBandX, guardBandY);
+                for (int k = 0; k < vertexCount; ++k) {
+                    polygon[k] = viewportTransform(clipped[k].position.projected());
+                }
             }
             
-            // Rasterize triangle fill
-            fillTriangle_Scanline(v0_screen, v1_screen, v2_screen, meshColor);
+            // Fan-triangulate the (possibly clipped) polygon. A triangle that
+            // is not drawn at all counts as culled for the first part's reason.
+            bool anyVisible = false;
+            TriangleTest rejection = TriangleTest::OffScreen;   // Nothing left after clipping
+            for (int k = 1; k + 1 < vertexCount; ++k) {
+                const Vector3& v0_screen = polygon[0];
+                const Vector3& v1_screen = polygon[k];
+                const Vector3& v2_screen = polygon[k + 1];
+                
+                // Screen bounds, back-face and degenerate tests
+                TriangleTest test = testTriangle(v0_screen, v1_screen, v2_screen);
+                if (test != TriangleTest::Visible) {
+                    if (k == 1) rejection = test;
+                    continue;
+                }
+                
+                // Queue triangle fill
+                submitFlatTriangle(v0_screen, v1_screen, v2_screen, meshColor);
+                anyVisible = true;
+            }
+            if (!anyVisible) countCulledTriangle(rejection);
             
-            // Store triangle for edge rendering (with slightly closer z for priority)
-            Vector3 v0_edge = Vector3(v0_screen.x, v0_screen.y, v0_screen.z - 0.001f);
-            Vector3 v1_edge = Vector3(v1_screen.x, v1_screen.y, v1_screen.z - 0.001f);
-            Vector3 v2_edge = Vector3(v2_screen.x, v2_screen.y, v2_screen.z - 0.001f);
-            visibleTriangles.push_back(std::make_tuple(v0_edge, v1_edge, v2_edge));
+            // Store the polygon outline for edge rendering (with slightly closer z for priority)
+            if (anyVisible) {
+                for (int k = 0; k < vertexCount; ++k) {
+                    const Vector3& a = polygon[k];
+                    const Vector3& b = polygon[(k + 1) % vertexCount];
+                    visibleEdges.push_back(std::make_pair(Vector3(a.x, a.y, a.z - 0.001f),
+                                                          Vector3(b.x, b.y, b.z - 0.001f)));
+                }
+            }
         }
         
         // Second pass: Render triangle edges on top
-        Color edgeColor = Color(255, 255, 255); // White edges
-        for (const auto& triangle : visibleTriangles) {
-            Vector3 v0 = std::get<0>(triangle);
-            Vector3 v1 = std::get<1>(triangle);
-            Vector3 v2 = std::get<2>(triangle);
-            
-            // Draw the three edges of the triangle
-            drawLine_Bresenham_Depth(static_cast<int>(v0.x), static_cast<int>(v0.y), 
-                                    static_cast<int>(v1.x), static_cast<int>(v1.y), 
-                                    v0.z, v1.z, edgeColor);
-                              
-            drawLine_Bresenham_Depth(static_cast<int>(v1.x), static_cast<int>(v1.y), 
-                                    static_cast<int>(v2.x), static_cast<int>(v2.y), 
-                                    v1.z, v2.z, edgeColor);
-                              
-            drawLine_Bresenham_Depth(static_cast<int>(v2.x), static_cast<int>(v2.y), 
-                                    static_cast<int>(v0.x), static_cast<int>(v0.y), 
-                                    v2.z, v0.z, edgeColor);
+        LinearColor edgeColor(1.0f, 1.0f, 1.0f); // White edges
+        for (const auto& edge : visibleEdges) {
+            submitDepthLine(edge.first, edge.second, edgeColor);
         }
     }
     
-    // Simple completion message for first render only
-    static bool firstRender = true;
-    if (firstRender) {
-        printf("Renderer: Successfully processed %zu meshes\n", meshes.size());
-        firstRender = false;
-    }
+    // Rasterize everything queued for this pass
+    timer.switchTo(frameStats.rasterMs);
+    flushRasterCommands();
 }
 
-void Renderer::render_Light(const std::vector<Mesh>& meshes, const Camera& camera, 
-                           const std::vector<Light>& lights, const Material& material) {
+void Renderer::drawLitMeshes(const Camera& camera, const Frustum* frustum,
+                             const std::vector<Light>& lights, const Material& material, bool objectNormals) {
+    TRACE_SCOPE("Renderer::drawLitMeshes");
+    StageTimer timer(frameStats.transformMs);
+    
     // Get combined view-projection matrix
     Matrix4 viewProjMatrix = camera.getViewProjectionMatrix();
     
+    // Rasterize occluders before any mesh is submitted
+    if (occlusionCulling) {
+        buildOcclusionBuffer(camera, frustum, viewProjMatrix);
+    }
+    
+    // Light constants for the whole pass (camera position for view directions)
+    lightingEngine.prepare(lights, material, camera.position);
+    
     // Render each mesh with Gouraud shading
-    for (size_t meshIndex = 0; meshIndex < meshes.size(); ++meshIndex) {
-        const Mesh& mesh = meshes[meshIndex];
+    for (const DrawItem& item : drawItems) {
+        const MeshData& mesh = *item.geometry;
         
         // Get mesh transformation matrix
-        Matrix4 worldMatrix = mesh.getWorldTransformMatrix();
+        const Matrix4& worldMatrix = item.worldMatrix;
         Matrix4 mvpMatrix = viewProjMatrix * worldMatrix;
         
-        // Render triangles with Gouraud lighting (no edges)
-        for (size_t i = 0; i < mesh.getTriangleCount(); ++i) {
-            Triangle triangle = mesh.getTriangle(i);
-            
-            // Transform vertices to clip space
-            Vector3 v0_clip = mvpMatrix.multiply(triangle.v0.position);
-            Vector3 v1_clip = mvpMatrix.multiply(triangle.v1.position);
-            Vector3 v2_clip = mvpMatrix.multiply(triangle.v2.position);
-            
-            // Perspective division (clip space to NDC)
-            if (v0_clip.z <= 0.0f || v1_clip.z <= 0.0f || v2_clip.z <= 0.0f) continue; // Behind camera
-            
-            Vector3 v0_ndc = Vector3(v0_clip.x / v0_clip.z, v0_clip.y / v0_clip.z, v0_clip.z);
-            Vector3 v1_ndc = Vector3(v1_clip.x / v1_clip.z, v1_clip.y / v1_clip.z, v1_clip.z);
-            Vector3 v2_ndc = Vector3(v2_clip.x / v2_clip.z, v2_clip.y / v2_clip.z, v2_clip.z);
+        // Skip meshes outside the frustum or hidden behind occluders
+        if (cullMesh(mesh, worldMatrix, mvpMatrix, frustum)) continue;
+        
+        size_t lod = selectLOD(item, camera);
+        size_t triangleCount = mesh.getLODTriangleCount(lod);
+        size_t vertexCount = mesh.getLODVertexCount(lod);
+        cullStats.lodTrianglesSkipped += mesh.getTriangleCount() - triangleCount;
+        FRAME_STATS_ADD(frameStats.trianglesSubmitted, triangleCount);
+        
+        // Vertex processing: transform each unique vertex once (screen and world space)
+        transformVertices(mesh, mvpMatrix, vertexCount);
+        transformVerticesToWorld(mesh, worldMatrix, vertexCount);
+        
+        // Precomputed object-space face normals only need rotating into world space;
+        // vertex normals (when the mesh has them) replace face normals entirely
+        bool smooth = mesh.hasVertexNormals();
+        const Vector3* faceNormals = objectNormals && !smooth ? getObjectFaceNormals(mesh, lod) : nullptr;
+        NormalMatrix normalMatrix = faceNormals || smooth ? makeNormalMatrix(worldMatrix) : NormalMatrix();
+        
+        // Textured meshes also carry texture coordinates through clipping
+        const Texture* texture = item.texture && !item.texture->isEmpty() && mesh.hasTexCoords() ? item.texture
+                                                                                                : nullptr;
+        
+        // Triangle setup: cull, then give each corner a slot in the lit color
+        // buffer, shared by all corners with the same vertex and normal
+        litTriangles.clear();
+        litEntries.clear();
+        litVertexHeads.assign(vertexCount, NO_LIT_ENTRY);
+        auto getLitSlot = [&](unsigned int vertex, const Vector3& normal) {
+            for (unsigned int e = litVertexHeads[vertex]; e != NO_LIT_ENTRY; e = litEntries[e].next) {
+                const Vector3& cached = litEntries[e].normal;
+                if (std::fabs(cached.x - normal.x) <= NORMAL_MATCH_TOLERANCE &&
+                    std::fabs(cached.y - normal.y) <= NORMAL_MATCH_TOLERANCE &&
+                    std::fabs(cached.z - normal.z) <= NORMAL_MATCH_TOLERANCE) return e;
+            }
+            litEntries.push_back(LitEntry{ normal, vertex, litVertexHeads[vertex] });
+            litVertexHeads[vertex] = static_cast<unsigned int>(litEntries.size() - 1);
+            return litVertexHeads[vertex];
+        };
+        auto getSmoothSlot = [&](unsigned int vertex) {
+            if (litVertexHeads[vertex] != NO_LIT_ENTRY) return litVertexHeads[vertex];
+            Vector3 normal = normalMatrix.multiply(mesh.getVertexNormal(vertex)).normalized();
+            return getLitSlot(vertex, normalMatrix.mirrors ? normal * -1.0f : normal);
+        };
+        
+        const unsigned int* indexData = mesh.getLODIndexData(lod);
+        for (size_t i = 0; i < triangleCount; ++i) {
+            // Triangle assembly from the post-transform cache
+            unsigned int i0 = indexData[i * 3];
+            unsigned int i1 = indexData[i * 3 + 1];
+            unsigned int i2 = indexData[i * 3 + 2];
+            const TransformedVertex& t0 = transformedVertices[i0];
+            const TransformedVertex& t1 = transformedVertices[i1];
+            const TransformedVertex& t2 = transformedVertices[i2];
             
-            // Simple clipping: skip triangles that are completely outside the view volume
-            if (v0_ndc.x < -1.0f && v1_ndc.x < -1.0f && v2_ndc.x < -1.0f) continue; // Left of screen
-            if (v0_ndc.x > 1.0f && v1_ndc.x > 1.0f && v2_ndc.x > 1.0f) continue;   // Right of screen
-            if (v0_ndc.y < -1.0f && v1_ndc.y < -1.0f && v2_ndc.y < -1.0f) continue; // Below screen
-            if (v0_ndc.y > 1.0f && v1_ndc.y > 1.0f && v2_ndc.y > 1.0f) continue;   // Above screen
+            // Skip triangles entirely outside one of the view volume planes
+            TriangleTest outcodeTest = testOutcodes(t0.outcode, t1.outcode, t2.outcode);
+            if (outcodeTest != TriangleTest::Visible) {
+                countCulledTriangle(outcodeTest);
+                continue;
+            }
             
-            // Transform to screen coordinates
-            Vector3 v0_screen = viewportTransform(v0_ndc);
-            Vector3 v1_screen = viewportTransform(v1_ndc);
-            Vector3 v2_screen = viewportTransform(v2_ndc);
+            // Triangles inside the guard band can be rejected now; clipped ones
+            // are tested after clipping
+            bool clipped = ((t0.outcode | t1.outcode | t2.outcode) & CLIP_REQUIRED) != 0;
+            if (!clipped) {
+                TriangleTest test = testTriangle(t0.screen, t1.screen, t2.screen);
+                if (test != TriangleTest::Visible) {
+                    countCulledTriangle(test);
+                    continue;
+                }
+            }
             
-            // Check if triangle is visible on screen
-            if (!isTriangleVisible(v0_screen, v1_screen, v2_screen)) {
-                continue;
+            LitTriangle triangle = { { i0, i1, i2 }, { 0, 0, 0 }, clipped };
+            if (smooth) {
+                triangle.slots[0] = getSmoothSlot(i0);
+                triangle.slots[1] = getSmoothSlot(i1);
+                triangle.slots[2] = getSmoothSlot(i2);
+            } else {
+                // Calculate face normal for this triangle
+                Vector3 faceNormal = faceNormals ? normalMatrix.transform(faceNormals[i])
+                                                 : calculateFaceNormal(worldVertices[i0], worldVertices[i1],
+                                                                       worldVertices[i2]);
+                triangle.slots[0] = getLitSlot(i0, faceNormal);
+                triangle.slots[1] = getLitSlot(i1, faceNormal);
+                triangle.slots[2] = getLitSlot(i2, faceNormal);
+            }
+            litTriangles.push_back(triangle);
+        }
+        
+        // Lighting: once per unique (vertex, normal) instead of once per corner,
+        // batched over SoA copies of the entries
+        timer.switchTo(frameStats.lightingMs);
+        size_t litCount = litEntries.size();
+        litPositionX.resize(litCount);
+        litPositionY.resize(litCount);
+        litPositionZ.resize(litCount);
+        litNormalX.resize(litCount);
+        litNormalY.resize(litCount);
+        litNormalZ.resize(litCount);
+        for (size_t e = 0; e < litCount; ++e) {
+            const LitEntry& entry = litEntries[e];
+            const Vector3& position = worldVertices[entry.vertex];
+            litPositionX[e] = position.x;
+            litPositionY[e] = position.y;
+            litPositionZ[e] = position.z;
+            litNormalX[e] = entry.normal.x;
+            litNormalY[e] = entry.normal.y;
+            litNormalZ[e] = entry.normal.z;
+        }
+        litColors.resize(litCount);
+        lightingEngine.evaluate(litPositionX.data(), litPositionY.data(), litPositionZ.data(),
+                                litNormalX.data(), litNormalY.data(), litNormalZ.data(), litCount, litColors.data());
+        lightingStats.corners += litTriangles.size() * 3;
+        lightingStats.litVertices += litEntries.size();
+        FRAME_STATS_ADD(frameStats.lightingEvaluations, litCount);
+        timer.switchTo(frameStats.transformMs);
+        
+        // Render triangles with Gouraud lighting (no edges)
+        for (const LitTriangle& triangle : litTriangles) {
+            const TransformedVertex& t0 = transformedVertices[triangle.vertices[0]];
+            const TransformedVertex& t1 = transformedVertices[triangle.vertices[1]];
+            const TransformedVertex& t2 = transformedVertices[triangle.vertices[2]];
+            const LinearColor& c0 = litColors[triangle.slots[0]];
+            const LinearColor& c1 = litColors[triangle.slots[1]];
+            const LinearColor& c2 = litColors[triangle.slots[2]];
+            float u0 = 0.0f, v0 = 0.0f, u1 = 0.0f, v1 = 0.0f, u2 = 0.0f, v2 = 0.0f;
+            if (texture) {
+                mesh.getVertexTexCoord(triangle.vertices[0], u0, v0);
+                mesh.getVertexTexCoord(triangle.vertices[1], u1, v1);
+                mesh.getVertexTexCoord(triangle.vertices[2], u2, v2);
             }
             
-            // Back-face culling
-            if (!isBackFace(v0_screen, v1_screen, v2_screen)) {
+            if (!triangle.clipped) {
+                // Fast path: the whole triangle projects inside the guard band
+                // Queue triangle with interpolated colors (Gouraud shading)
+                if (texture) {
+                    // Texture coordinates over w interpolate linearly in screen space
+                    float w0 = 1.0f / t0.clip.w, w1 = 1.0f / t1.clip.w, w2 = 1.0f / t2.clip.w;
+                    submitTexturedTriangle(t0.screen, t1.screen, t2.screen, c0, c1, c2,
+                                           Vector3(u0 * w0, v0 * w0, w0), Vector3(u1 * w1, v1 * w1, w1),
+                                           Vector3(u2 * w2, v2 * w2, w2), *texture);
+                } else {
+                    submitGouraudTriangle(t0.screen, t1.screen, t2.screen, c0, c1, c2);
+                }
                 continue;
             }
             
-            // Calculate world space positions for lighting
-            Vector3 v0_world = worldMatrix.multiply(triangle.v0.position);
-            Vector3 v1_world = worldMatrix.multiply(triangle.v1.position);
-            Vector3 v2_world = worldMatrix.multiply(triangle.v2.position);
+            // Clipped path: clip the lit triangle in homogeneous space so the
+            // colors are interpolated along the clipped edges
+            ClipVertex polygon[MAX_CLIP_VERTICES] = {
+                makeClipVertex(t0.clip, c0, u0, v0),
+                makeClipVertex(t1.clip, c1, u1, v1),
+                makeClipVertex(t2.clip, c2, u2, v2)
+            };
+            int vertexCount = clipTriangle(polygon, guardBandX, guardBandY);
             
-            // Calculate face normal for this triangle
-            Vector3 faceNormal = calculateFaceNormal(v0_world, v1_world, v2_world);
+            Vector3 screen[MAX_CLIP_VERTICES];
+            LinearColor colors[MAX_CLIP_VERTICES];
+            Vector3 texCoords[MAX_CLIP_VERTICES];
+            for (int k = 0; k < vertexCount; ++k) {
+                screen[k] = viewportTransform(polygon[k].position.projected());
+                colors[k] = LinearColor(polygon[k].r, polygon[k].g, polygon[k].b);
+                float invW = 1.0f / polygon[k].position.w;
+                texCoords[k] = Vector3(polygon[k].u * invW, polygon[k].v * invW, invW);
+            }
             
-            // Get camera position for view direction calculation
-            Vector3 viewPos = camera.position;
+            // Fan-triangulate the clipped polygon (counted like in drawMeshes)
+            bool anyVisible = false;
+            TriangleTest rejection = TriangleTest::OffScreen;
+            for (int k = 1; k + 1 < vertexCount; ++k) {
+                TriangleTest test = testTriangle(screen[0], screen[k], screen[k + 1]);
+                if (test != TriangleTest::Visible) {
+                    if (k == 1) rejection = test;
+                    continue;
+                }
+                if (texture) {
+                    submitTexturedTriangle(screen[0], screen[k], screen[k + 1], colors[0], colors[k], colors[k + 1],
+                                           texCoords[0], texCoords[k], texCoords[k + 1], *texture);
+                } else {
+                    submitGouraudTriangle(screen[0], screen[k], screen[k + 1], colors[0], colors[k], colors[k + 1]);
+                }
+                anyVisible = true;
+            }
+            if (!anyVisible) countCulledTriangle(rejection);
+        }
+    }
+    
+    // Rasterize everything queued for this pass
+    timer.switchTo(frameStats.rasterMs);
+    flushRasterCommands();
+}
+
+#ifndef HEADLESS
+void Renderer::present(sf::RenderWindow& window) {
+    // Not timed in the other overload, which may run alongside the next frame
+    StageTimer timer(frameStats.presentMs);
+    present(window, pixels);
+}
+
+void Renderer::present(sf::RenderWindow& window, const std::vector<std::uint32_t>& framePixels) {
+    TRACE_SCOPE("Renderer::present");
+    if (displayTexture->getSize().x == 0) return; // Texture creation failed
+    
+    // The resolved pixels are already RGBA8 bytes (see AccumulationBuffer::resolve),
+    // so they are uploaded straight from the buffer without an intermediate image
+    displayTexture->update(reinterpret_cast<const std::uint8_t*>(framePixels.data()));
+    window.draw(*displaySprite);
+}
+#endif
+
+void Renderer::resolve() {
+    resolve(pixels);
+}
+
+void Renderer::resolve(std::vector<std::uint32_t>& target) {
+    StageTimer timer(frameStats.presentMs);
+    TRACE_SCOPE("Renderer::resolve");
+    size_t pixelCount = colorBuffer.getPixelCount();
+    target.resize(pixelCount);
+    
+    // Bands of whole tile rows, resolved in parallel
+    size_t bandPixels = static_cast<size_t>(TILE_SIZE) * screenWidth;
+    size_t bandCount = (pixelCount + bandPixels - 1) / bandPixels;
+    std::uint32_t* out = target.data();
+    threadPool->parallelFor(bandCount, [this, out, bandPixels, pixelCount](size_t band) {
+        size_t first = band * bandPixels;
+        colorBuffer.resolve(out, first, std::min(bandPixels, pixelCount - first));
+    });
+}
+
+bool Renderer::saveToPPM(const std::string& filename) const {
+    return saveToPPM(filename, pixels);
+}
+
+bool Renderer::saveToPPM(const std::string& filename, const std::vector<std::uint32_t>& framePixels) const {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    // Binary PPM (P6): header followed by raw RGB triplets
+    file << "P6\n" << screenWidth << " " << screenHeight << "\n255\n";
+    for (std::uint32_t pixel : framePixels) {
+        const char rgb[3] = { static_cast<char>(pixel & 0xFF), static_cast<char>((pixel >> 8) & 0xFF),
+                              static_cast<char>((pixel >> 16) & 0xFF) };
+        file.write(rgb, 3);
+    }
+    return file.good();
+}
+
+void Renderer::setThreadCount(int threadCount) {
+    if (threadCount < 0) threadCount = 0;
+    threadPool = std::make_unique<ThreadPool>(static_cast<size_t>(threadCount));
+}
+
+int Renderer::getThreadCount() const {
+    return static_cast<int>(threadPool->getThreadCount());
+}
+
+// Raster command queue
+void Renderer::submitFlatTriangle(const Vector3& v0, const Vector3& v1, const Vector3& v2, const LinearColor& color) {
+    RasterCommand command;
+    command.type = RasterCommand::FlatTriangle;
+    command.v0 = v0; command.v1 = v1; command.v2 = v2;
+    command.c0 = color;
+    rasterCommands.push_back(command);
+}
+
+void Renderer::submitGouraudTriangle(const Vector3& v0, const Vector3& v1, const Vector3& v2,
+                                     const LinearColor& c0, const LinearColor& c1, const LinearColor& c2) {
+    RasterCommand command;
+    command.type = RasterCommand::GouraudTriangle;
+    command.v0 = v0; command.v1 = v1; command.v2 = v2;
+    command.c0 = c0; command.c1 = c1; command.c2 = c2;
+    rasterCommands.push_back(command);
+}
+
+void Renderer::submitTexturedTriangle(const Vector3& v0, const Vector3& v1, const Vector3& v2,
+                                      const LinearColor& c0, const LinearColor& c1, const LinearColor& c2,
+                                      const Vector3& t0, const Vector3& t1, const Vector3& t2,
+                                      const Texture& texture) {
+    RasterCommand command;
+    command.type = RasterCommand::TexturedTriangle;
+    command.v0 = v0; command.v1 = v1; command.v2 = v2;
+    command.c0 = c0; command.c1 = c1; command.c2 = c2;
+    command.t0 = t0; command.t1 = t1; command.t2 = t2;
+    command.texture = &texture;
+    rasterCommands.push_back(command);
+}
+
+void Renderer::submitDepthLine(const Vector3& v0, const Vector3& v1, const LinearColor& color) {
+    RasterCommand command;
+    command.type = RasterCommand::DepthLine;
+    command.v0 = v0; command.v1 = v1;
+    command.c0 = color;
+    rasterCommands.push_back(command);
+}
+
+void Renderer::flushRasterCommands() {
+    TRACE_SCOPE("Renderer::flushRasterCommands");
+    ScreenRect screen = { 0, 0, screenWidth - 1, screenHeight - 1 };
+    
+    // Serial path: execute in submission order over the whole screen
+    if (threadPool->getThreadCount() <= 1) {
+        PixelCounters counters;
+        for (const RasterCommand& command : rasterCommands) {
+            executeRasterCommand(command, screen, counters);
+        }
+        FRAME_STATS_ADD(frameStats.pixelsTested, counters.tested);
+        FRAME_STATS_ADD(frameStats.pixelsPassed, counters.passed);
+        rasterCommands.clear();
+        return;
+    }
+    
+    // Binning: append each command to every tile its bounding box touches.
+    // Tiles keep submission order, so per-pixel results match the serial path.
+    for (Tile& tile : tiles) {
+        tile.commands.clear();
+        tile.counters = PixelCounters();
+    }
+    
+    for (size_t i = 0; i < rasterCommands.size(); ++i) {
+        ScreenRect bounds = getCommandBounds(rasterCommands[i]);
+        if (bounds.maxX < 0 || bounds.minX >= screenWidth ||
+            bounds.maxY < 0 || bounds.minY >= screenHeight) {
+            continue;
+        }
+        
+        int tileMinX = std::max(0, bounds.minX) / TILE_SIZE;
+        int tileMaxX = std::min(screenWidth - 1, bounds.maxX) / TILE_SIZE;
+        int tileMinY = std::max(0, bounds.minY) / TILE_SIZE;
+        int tileMaxY = std::min(screenHeight - 1, bounds.maxY) / TILE_SIZE;
+        
+        for (int ty = tileMinY; ty <= tileMaxY; ++ty) {
+            for (int tx = tileMinX; tx <= tileMaxX; ++tx) {
+                tiles[ty * tilesX + tx].commands.push_back(static_cast<unsigned int>(i));
+            }
+        }
+    }
+    
+    // Each tile owns a disjoint block of the color and depth buffers,
+    // so workers rasterize without any locking
+    threadPool->parallelFor(tiles.size(), [this](size_t tileIndex) {
+        Tile& tile = tiles[tileIndex];
+        if (tile.commands.empty()) return;
+        TRACE_SCOPE("Raster tile");
+        for (unsigned int commandIndex : tile.commands) {
+            executeRasterCommand(rasterCommands[commandIndex], tile.bounds, tile.counters);
+        }
+    });
+    
+#if FRAME_STATS
+    for (const Tile& tile : tiles) {
+        frameStats.pixelsTested += tile.counters.tested;
+        frameStats.pixelsPassed += tile.counters.passed;
+    }
+#endif
+    rasterCommands.clear();
+}
+
+void Renderer::executeRasterCommand(const RasterCommand& command, const ScreenRect& clip, PixelCounters& counters) {
+    switch (command.type) {
+        case RasterCommand::FlatTriangle:
+            fillTriangle_Scanline(command.v0, command.v1, command.v2, command.c0, clip, counters);
+            break;
+        case RasterCommand::GouraudTriangle:
+            fillTriangle_Gouraud(command.v0, command.v1, command.v2,
+                                 command.c0, command.c1, command.c2, clip, counters);
+            break;
+        case RasterCommand::TexturedTriangle:
+            fillTriangle_Textured(command.v0, command.v1, command.v2, command.c0, command.c1, command.c2,
+                                  command.t0, command.t1, command.t2, *command.texture, clip, counters);
+            break;
+        case RasterCommand::DepthLine:
+            drawLine_Bresenham_Depth(static_cast<int>(command.v0.x), static_cast<int>(command.v0.y),
+                                     static_cast<int>(command.v1.x), static_cast<int>(command.v1.y),
+                                     command.v0.z, command.v1.z, command.c0, clip, counters);
+            break;
+    }
+}
+
+Renderer::ScreenRect Renderer::getCommandBounds(const RasterCommand& command) const {
+    ScreenRect bounds;
+    if (command.type == RasterCommand::DepthLine) {
+        // Lines rasterize between their truncated integer endpoints
+        int x0 = static_cast<int>(command.v0.x), y0 = static_cast<int>(command.v0.y);
+        int x1 = static_cast<int>(command.v1.x), y1 = static_cast<int>(command.v1.y);
+        bounds.minX = std::min(x0, x1);
+        bounds.maxX = std::max(x0, x1);
+        bounds.minY = std::min(y0, y1);
+        bounds.maxY = std::max(y0, y1);
+    } else {
+        // floor/ceil covers both the truncating and the ceil-based rasterizers
+        bounds.minX = static_cast<int>(std::floor(std::min({command.v0.x, command.v1.x, command.v2.x})));
+        bounds.maxX = static_cast<int>(std::ceil(std::max({command.v0.x, command.v1.x, command.v2.x})));
+        bounds.minY = static_cast<int>(std::floor(std::min({command.v0.y, command.v1.y, command.v2.y})));
+        bounds.maxY = static_cast<int>(std::ceil(std::max({command.v0.y, command.v1.y, command.v2.y})));
+    }
+    return bounds;
+}
+
+void Renderer::initTiles() {
+    tilesX = (screenWidth + TILE_SIZE - 1) / TILE_SIZE;
+    tilesY = (screenHeight + TILE_SIZE - 1) / TILE_SIZE;
+    
+    tiles.resize(tilesX * tilesY);
+    for (int ty = 0; ty < tilesY; ++ty) {
+        for (int tx = 0; tx < tilesX; ++tx) {
+            ScreenRect& bounds = tiles[ty * tilesX + tx].bounds;
+            bounds.minX = tx * TILE_SIZE;
+            bounds.minY = ty * TILE_SIZE;
+            bounds.maxX = std::min(screenWidth, (tx + 1) * TILE_SIZE) - 1;
+            bounds.maxY = std::min(screenHeight, (ty + 1) * TILE_SIZE) - 1;
+        }
+    }
+}
+
+// Mesh culling
+void Renderer::buildOcclusionBuffer(const Camera& camera, const Frustum* frustum, const Matrix4& viewProjMatrix) {
+    TRACE_SCOPE("Renderer::buildOcclusionBuffer");
+    occlusionBuffer.clear();
+    
+    // Marked occluders, or the nearest meshes to the camera when none are marked.
+    // Meshes outside the frustum cannot hide anything.
+    occluderIndices.clear();
+    for (size_t i = 0; i < drawItems.size(); ++i) {
+        if (drawItems[i].occluder) occluderIndices.push_back(i);
+    }
+    if (occluderIndices.empty()) {
+        occluderIndices.resize(drawItems.size());
+        for (size_t i = 0; i < drawItems.size(); ++i) {
+            occluderIndices[i] = i;
+        }
+        
+        // Distance to the world-space origin of each mesh (the translation column)
+        auto distanceSq = [&](size_t index) {
+            const Matrix4& world = drawItems[index].worldMatrix;
+            Vector3 offset = Vector3(world.m[0][3], world.m[1][3], world.m[2][3]) - camera.position;
+            return offset.dot(offset);
+        };
+        size_t count = std::min(DEFAULT_OCCLUDER_COUNT, occluderIndices.size());
+        std::partial_sort(occluderIndices.begin(), occluderIndices.begin() + count, occluderIndices.end(),
+                          [&](size_t a, size_t b) { return distanceSq(a) < distanceSq(b); });
+        occluderIndices.resize(count);
+    }
+    
+    for (size_t itemIndex : occluderIndices) {
+        const MeshData& mesh = *drawItems[itemIndex].geometry;
+        const Matrix4& worldMatrix = drawItems[itemIndex].worldMatrix;
+        if (frustum && !isMeshInFrustum(mesh, worldMatrix, *frustum)) continue;
+        
+        transformVertices(mesh, viewProjMatrix * worldMatrix, mesh.getVertexCount());
+        
+        const unsigned int* indexData = mesh.getIndexData();
+        for (size_t i = 0; i < mesh.getTriangleCount(); ++i) {
+            const TransformedVertex& t0 = transformedVertices[indexData[i * 3]];
+            const TransformedVertex& t1 = transformedVertices[indexData[i * 3 + 1]];
+            const TransformedVertex& t2 = transformedVertices[indexData[i * 3 + 2]];
             
-            // Calculate Gouraud lighting at each vertex using Light's computeColor method
-            Color c0 = computeVertexLighting(v0_world, faceNormal, viewPos, lights, material);
-            Color c1 = computeVertexLighting(v1_world, faceNormal, viewPos, lights, material);
-            Color c2 = computeVertexLighting(v2_world, faceNormal, viewPos, lights, material);
+            // Only unclipped, front-facing triangles occlude (skipping the rest is conservative)
+            if ((t0.outcode | t1.outcode | t2.outcode) & CLIP_REQUIRED) continue;
+            if (t0.outcode & t1.outcode & t2.outcode & CLIP_PLANES) continue;
+            if (!isBackFace(t0.screen, t1.screen, t2.screen)) continue;
             
-            // Rasterize triangle with interpolated colors (Gouraud shading)
-            fillTriangle_Gouraud(v0_screen, v1_screen, v2_screen, c0, c1, c2);
+            occlusionBuffer.rasterizeOccluder(t0.screen, t1.screen, t2.screen);
         }
     }
+}
+
+bool Renderer::cullMesh(const MeshData& mesh, const Matrix4& worldMatrix, const Matrix4& mvpMatrix,
+                        const Frustum* frustum) {
+    ++cullStats.meshesTested;
+    
+    if (frustum && !isMeshInFrustum(mesh, worldMatrix, *frustum)) {
+        ++cullStats.frustumCulled;
+        cullStats.trianglesCulled += mesh.getTriangleCount();
+        return true;
+    }
     
-    // Simple completion message for first render only
-    static bool firstLightRender = true;
-    if (firstLightRender) {
-        printf("Renderer: Successfully processed %zu meshes with lighting\n", meshes.size());
-        firstLightRender = false;
+    if (occlusionCulling && isMeshOccluded(mesh, mvpMatrix)) {
+        ++cullStats.occlusionCulled;
+        cullStats.trianglesCulled += mesh.getTriangleCount();
+        return true;
     }
+    
+    ++cullStats.meshesRendered;
+    return false;
 }
 
-void Renderer::present(sf::RenderWindow& window) {
-    // Copy frame buffer to SFML image
-    for (int y = 0; y < screenHeight; ++y) {
-        for (int x = 0; x < screenWidth; ++x) {
-            const Color& pixel = frameBuffer[y * screenWidth + x];
-            displayImage->setPixel(sf::Vector2u(x, y), sf::Color(pixel.r, pixel.g, pixel.b));
+bool Renderer::isMeshInFrustum(const MeshData& mesh, const Matrix4& worldMatrix, const Frustum& frustum) const {
+    // The sphere test is cheap and settles most meshes; the box is tighter for the rest
+    Frustum::TestResult sphereResult = frustum.testSphere(mesh.getBoundingSphere().transformed(worldMatrix));
+    if (sphereResult != Frustum::INTERSECTS) {
+        return sphereResult == Frustum::INSIDE;
+    }
+    return frustum.testAABB(mesh.getBounds().transformed(worldMatrix)) != Frustum::OUTSIDE;
+}
+
+bool Renderer::isMeshOccluded(const MeshData& mesh, const Matrix4& mvpMatrix) {
+    const AABB& bounds = mesh.getBounds();
+    if (bounds.isEmpty()) return false;
+    
+    float minX = std::numeric_limits<float>::max(), maxX = -std::numeric_limits<float>::max();
+    float minY = std::numeric_limits<float>::max(), maxY = -std::numeric_limits<float>::max();
+    float minZ = std::numeric_limits<float>::max();
+    
+    // Screen rectangle and nearest depth of the projected bounding box
+    for (int corner = 0; corner < 8; ++corner) {
+        Vector3 local((corner & 1) ? bounds.max.x : bounds.min.x,
+                      (corner & 2) ? bounds.max.y : bounds.min.y,
+                      (corner & 4) ? bounds.max.z : bounds.min.z);
+        Vector4 clip = mvpMatrix.multiplyHomogeneous(local);
+        
+        // A box reaching behind the near plane has no finite screen bounds
+        if (clip.z < -clip.w) return false;
+        
+        Vector3 screen = viewportTransform(clip.projected());
+        minX = std::min(minX, screen.x);
+        maxX = std::max(maxX, screen.x);
+        minY = std::min(minY, screen.y);
+        maxY = std::max(maxY, screen.y);
+        minZ = std::min(minZ, screen.z);
+    }
+    
+    return occlusionBuffer.isRectOccluded(minX, minY, maxX, maxY, minZ);
+}
+
+size_t Renderer::selectLOD(const DrawItem& item, const Camera& camera) {
+    const MeshData& mesh = *item.geometry;
+    size_t levelCount = mesh.getLODCount();
+    if (levelCount == 1 || lodPixelError <= 0.0f) {
+        *item.lodLevel = 0;
+        return 0;
+    }
+    
+    // Pixels per world unit at the nearest point of the bounding sphere
+    const BoundingSphere& objectSphere = mesh.getBoundingSphere();
+    BoundingSphere sphere = objectSphere.transformed(item.worldMatrix);
+    Vector3 toCenter = sphere.center - camera.position;
+    float distance = std::max(toCenter.length() - sphere.radius, camera.nearPlane);
+    float pixelsPerUnit = screenHeight / (2.0f * distance * std::tan(camera.fieldOfView * 0.5f));
+    
+    // LOD errors are in object units; scale them like the bounding sphere
+    float scale = objectSphere.radius > 0.0f ? sphere.radius / objectSphere.radius : 1.0f;
+    auto projectedError = [&](size_t level) { return mesh.getLODError(level) * scale * pixelsPerUnit; };
+    
+    size_t level = std::min<size_t>(*item.lodLevel, levelCount - 1);
+    while (level > 0 && projectedError(level) > lodPixelError) {
+        --level;
+    }
+    while (level + 1 < levelCount && projectedError(level + 1) <= lodPixelError * (1.0f - LOD_HYSTERESIS)) {
+        ++level;
+    }
+    
+    *item.lodLevel = static_cast<unsigned char>(level);
+    return level;
+}
+
+// Vertex processing
+void Renderer::transformVertices(const MeshData& mesh, const Matrix4& mvpMatrix, size_t count) {
+    transformedVertices.resize(count);
+    
+    // Batched transform of the SoA stream to homogeneous clip space
+    const float* clipX;
+    const float* clipY;
+    const float* clipZ;
+    const float* clipW;
+    transformPositionsHomogeneous(mesh, mvpMatrix, count, clipX, clipY, clipZ, clipW);
+    
+    for (size_t i = 0; i < count; ++i) {
+        TransformedVertex& out = transformedVertices[i];
+        Vector4 clip(clipX[i], clipY[i], clipZ[i], clipW[i]);
+        out.clip = clip;
+        
+        // Record which side of each clip plane the vertex lies on
+        unsigned char outcode = 0;
+        if (clip.x < -clip.w) outcode |= CLIP_LEFT;
+        if (clip.x > clip.w)  outcode |= CLIP_RIGHT;
+        if (clip.y < -clip.w) outcode |= CLIP_BOTTOM;
+        if (clip.y > clip.w)  outcode |= CLIP_TOP;
+        if (clip.z < -clip.w) outcode |= CLIP_NEAR;
+        if (clip.z > clip.w)  outcode |= CLIP_FAR;
+        
+        // In front of the near plane w >= near > 0, so the vertex can be projected.
+        // Far outside the screen it must still be clipped to keep raster math in range.
+        if (!(outcode & CLIP_NEAR)) {
+            float guardX = guardBandX * clip.w;
+            float guardY = guardBandY * clip.w;
+            if (clip.x < -guardX || clip.x > guardX || clip.y < -guardY || clip.y > guardY) {
+                outcode |= CLIP_GUARD;
+            } else {
+                out.screen = viewportTransform(clip.projected());
+            }
+        }
+        
+        out.outcode = outcode;
+    }
+}
+
+void Renderer::transformVerticesToWorld(const MeshData& mesh, const Matrix4& worldMatrix, size_t count) {
+    worldVertices.resize(count);
+    
+    const float* worldX;
+    const float* worldY;
+    const float* worldZ;
+    transformPositions(mesh, worldMatrix, count, worldX, worldY, worldZ);
+    
+    for (size_t i = 0; i < count; ++i) {
+        worldVertices[i] = Vector3(worldX[i], worldY[i], worldZ[i]);
+    }
+}
+
+void Renderer::transformPositionsHomogeneous(const MeshData& mesh, const Matrix4& matrix, size_t count,
+                                             const float*& outX, const float*& outY,
+                                             const float*& outZ, const float*& outW) {
+    if (mesh.isPositionStreamCurrent()) {
+        PositionStreamView stream = mesh.getPositionStreamView();
+        size_t paddedCount = getPaddedCount(count, stream);
+        if (transformedX.size() < paddedCount || transformedW.size() < paddedCount) {
+            transformedX.resize(std::max(transformedX.size(), paddedCount));
+            transformedY.resize(std::max(transformedY.size(), paddedCount));
+            transformedZ.resize(std::max(transformedZ.size(), paddedCount));
+            transformedW.resize(paddedCount);
+        }
+        matrix.transformPointsHomogeneous(stream.x, stream.y, stream.z,
+                                          transformedX.data(), transformedY.data(),
+                                          transformedZ.data(), transformedW.data(), paddedCount);
+    } else {
+        // Vertices were edited without updating the stream: fall back to the AoS data
+        if (transformedX.size() < count || transformedW.size() < count) {
+            transformedX.resize(std::max(transformedX.size(), count));
+            transformedY.resize(std::max(transformedY.size(), count));
+            transformedZ.resize(std::max(transformedZ.size(), count));
+            transformedW.resize(count);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            Vector4 result = matrix.multiplyHomogeneous(mesh.getVertexPosition(i));
+            transformedX[i] = result.x;
+            transformedY[i] = result.y;
+            transformedZ[i] = result.z;
+            transformedW[i] = result.w;
         }
     }
     
-    // Create texture from image each frame (less efficient but more reliable for debugging)
-    sf::Texture frameTexture;
-    if (frameTexture.loadFromImage(*displayImage)) {
-        sf::Sprite frameSprite(frameTexture);
-        window.draw(frameSprite);
+    outX = transformedX.data();
+    outY = transformedY.data();
+    outZ = transformedZ.data();
+    outW = transformedW.data();
+}
+
+void Renderer::transformPositions(const MeshData& mesh, const Matrix4& matrix, size_t count,
+                                  const float*& outX, const float*& outY, const float*& outZ) {
+    if (mesh.isPositionStreamCurrent()) {
+        // Output arrays share the stream's padding so the kernel runs full SIMD blocks
+        PositionStreamView stream = mesh.getPositionStreamView();
+        size_t paddedCount = getPaddedCount(count, stream);
+        if (transformedX.size() < paddedCount) {
+            transformedX.resize(paddedCount);
+            transformedY.resize(paddedCount);
+            transformedZ.resize(paddedCount);
+        }
+        matrix.transformPoints(stream.x, stream.y, stream.z,
+                               transformedX.data(), transformedY.data(), transformedZ.data(), paddedCount);
     } else {
-        static bool errorShown = false;
-        if (!errorShown) {
-            printf("ERROR: Failed to load texture from image!\n");
-            errorShown = true;
+        // Vertices were edited without updating the stream: fall back to the AoS data
+        if (transformedX.size() < count) {
+            transformedX.resize(count);
+            transformedY.resize(count);
+            transformedZ.resize(count);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            Vector3 result = matrix.multiply(mesh.getVertexPosition(i));
+            transformedX[i] = result.x;
+            transformedY[i] = result.y;
+            transformedZ[i] = result.z;
         }
     }
+    
+    outX = transformedX.data();
+    outY = transformedY.data();
+    outZ = transformedZ.data();
 }
 
 // Core pipeline implementation
@@ -249,14 +1301,17 @@ Vector3 Renderer::viewportTransform(const Vector3& clipSpaceVertex) {
 }
 
 // Pixel operations
-void Renderer::setPixel(int x, int y, const Color& color) {
+void Renderer::setPixel(int x, int y, const LinearColor& color) {
     if (x >= 0 && x < screenWidth && y >= 0 && y < screenHeight) {
-        frameBuffer[y * screenWidth + x] = color;
+        int index = y * screenWidth + x;
+        colorBuffer.getRed()[index] = color.r;
+        colorBuffer.getGreen()[index] = color.g;
+        colorBuffer.getBlue()[index] = color.b;
     }
 }
 
 // Bresenham line drawing algorithm
-void Renderer::drawLine_Bresenham(int x0, int y0, int x1, int y1, const Color& color) {
+void Renderer::drawLine_Bresenham(int x0, int y0, int x1, int y1, const LinearColor& color) {
     int dx = abs(x1 - x0);
     int dy = abs(y1 - y0);
     int sx = x0 < x1 ? 1 : -1;
@@ -284,7 +1339,8 @@ void Renderer::drawLine_Bresenham(int x0, int y0, int x1, int y1, const Color& c
 }
 
 // Depth-aware Bresenham line drawing algorithm with clipping
-void Renderer::drawLine_Bresenham_Depth(int x0, int y0, int x1, int y1, float z0, float z1, const Color& color) {
+void Renderer::drawLine_Bresenham_Depth(int x0, int y0, int x1, int y1, float z0, float z1, const LinearColor& color,
+                                        const ScreenRect& clip, PixelCounters& counters) {
     // Simple line clipping to screen bounds
     if ((x0 < 0 && x1 < 0) || (x0 >= screenWidth && x1 >= screenWidth) ||
         (y0 < 0 && y1 < 0) || (y0 >= screenHeight && y1 >= screenHeight)) {
@@ -304,8 +1360,8 @@ void Renderer::drawLine_Bresenham_Depth(int x0, int y0, int x1, int y1, float z0
     float lineLength = std::sqrt(static_cast<float>(dx * dx + dy * dy));
     
     while (true) {
-        // Only draw if pixel is within screen bounds
-        if (x >= 0 && x < screenWidth && y >= 0 && y < screenHeight) {
+        // Only draw if pixel is within the clip rectangle
+        if (x >= clip.minX && x <= clip.maxX && y >= clip.minY && y <= clip.maxY) {
             // Interpolate depth along the line
             float t = 0.0f;
             if (lineLength > 0.0f) {
@@ -315,7 +1371,9 @@ void Renderer::drawLine_Bresenham_Depth(int x0, int y0, int x1, int y1, float z0
             float z = z0 + t * (z1 - z0);
             
             // Use depth test before setting pixel
+            FRAME_STATS_ADD(counters.tested, 1);
             if (depthTest(x, y, z)) {
+                FRAME_STATS_ADD(counters.passed, 1);
                 setPixel(x, y, color);
             }
         }
@@ -334,76 +1392,41 @@ void Renderer::drawLine_Bresenham_Depth(int x0, int y0, int x1, int y1, float z0
     }
 }
 
-// Scanline triangle filling algorithm
-void Renderer::fillTriangle_Scanline(const Vector3& v0, const Vector3& v1, const Vector3& v2, const Color& color) {
-    // Sort vertices by Y coordinate
-    Vector3 vertices[3] = {v0, v1, v2};
-    std::sort(vertices, vertices + 3, [](const Vector3& a, const Vector3& b) {
-        return a.y < b.y;
-    });
-    
-    Vector3 top = vertices[0];
-    Vector3 mid = vertices[1];
-    Vector3 bottom = vertices[2];
+// Flat shaded scanline triangle filling (see setupTriangle() for the fill rule)
+void Renderer::fillTriangle_Scanline(const Vector3& v0, const Vector3& v1, const Vector3& v2, const LinearColor& color,
+                                     const ScreenRect& clip, PixelCounters& counters) {
+    TriangleSetup setup;
+    if (!setupTriangle(v0, v1, v2, clip.minX, clip.minY, clip.maxX, clip.maxY, setup)) return;
+    const AttributePlane zPlane = setup.makePlane(v0.z, v1.z, v2.z);
     
-    // Handle degenerate triangles
-    if (std::abs(top.y - bottom.y) < 0.5f) return;
-    
-    // Scanline fill
-    for (int y = static_cast<int>(std::ceil(top.y)); y <= static_cast<int>(bottom.y); ++y) {
-        if (y < 0 || y >= screenHeight) continue;
-        
-        float t1, t2;
-        Vector3 p1, p2;
-        
-        if (y <= mid.y) {
-            // Upper part of triangle
-            if (std::abs(top.y - mid.y) < 0.01f) continue;
-            t1 = (y - top.y) / (mid.y - top.y);
-            t2 = (y - top.y) / (bottom.y - top.y);
-            
-            p1 = Vector3(
-                top.x + t1 * (mid.x - top.x),
-                static_cast<float>(y),
-                top.z + t1 * (mid.z - top.z)
-            );
-            p2 = Vector3(
-                top.x + t2 * (bottom.x - top.x),
-                static_cast<float>(y),
-                top.z + t2 * (bottom.z - top.z)
-            );
-        } else {
-            // Lower part of triangle
-            if (std::abs(mid.y - bottom.y) < 0.01f) continue;
-            t1 = (y - mid.y) / (bottom.y - mid.y);
-            t2 = (y - top.y) / (bottom.y - top.y);
-            
-            p1 = Vector3(
-                mid.x + t1 * (bottom.x - mid.x),
-                static_cast<float>(y),
-                mid.z + t1 * (bottom.z - mid.z)
-            );
-            p2 = Vector3(
-                top.x + t2 * (bottom.x - top.x),
-                static_cast<float>(y),
-                top.z + t2 * (bottom.z - top.z)
-            );
+    // Scanline fill: each edge bounds the row's span from one side, found
+    // exactly from its integer edge function (inside where e + k * dx >= 0,
+    // k pixels from the row start)
+    long long edgeRow[3] = { setup.edgeOrigin[0], setup.edgeOrigin[1], setup.edgeOrigin[2] };
+    for (int y = setup.minY; y <= setup.maxY; ++y) {
+        long long first = 0;
+        long long last = setup.maxX - setup.minX;
+        for (int i = 0; i < 3; ++i) {
+            long long e = edgeRow[i];
+            long long dx = setup.edgeDx[i];
+            edgeRow[i] += setup.edgeDy[i];
+            if (dx > 0) {
+                first = std::max(first, floorDivide(-e + dx - 1, dx));
+            } else if (dx < 0) {
+                last = std::min(last, floorDivide(e, -dx));
+            } else if (e < 0) {
+                last = -1; // Row entirely outside a horizontal edge
+            }
         }
         
-        // Ensure p1 is left of p2
-        if (p1.x > p2.x) std::swap(p1, p2);
-        
         // Draw horizontal scanline
-        int startX = static_cast<int>(std::ceil(p1.x));
-        int endX = static_cast<int>(p2.x);
-        
-        for (int x = std::max(0, startX); x <= std::min(screenWidth - 1, endX); ++x) {
-            // Interpolate depth
-            float t = (p2.x == p1.x) ? 0.0f : (x - p1.x) / (p2.x - p1.x);
-            float depth = p1.z + t * (p2.z - p1.z);
+        for (int x = setup.minX + static_cast<int>(first); x <= setup.minX + last; ++x) {
+            float depth = zPlane.at(x, y);
             
             // Depth test
+            FRAME_STATS_ADD(counters.tested, 1);
             if (depthTest(x, y, depth)) {
+                FRAME_STATS_ADD(counters.passed, 1);
                 setPixel(x, y, color);
             }
         }
@@ -434,6 +1457,37 @@ bool Renderer::isTriangleVisible(const Vector3& v0, const Vector3& v1, const Vec
     return !(maxX < 0 || minX >= screenWidth || maxY < 0 || minY >= screenHeight);
 }
 
+Renderer::TriangleTest Renderer::testTriangle(const Vector3& v0, const Vector3& v1, const Vector3& v2) {
+    if (!isTriangleVisible(v0, v1, v2)) return TriangleTest::OffScreen;
+    if (isBackFace(v0, v1, v2)) return TriangleTest::Visible;
+    
+    // Rejected by the winding test: zero area is degenerate rather than back-facing
+    Vector3 edge1 = Vector3(v1.x - v0.x, v1.y - v0.y, 0);
+    Vector3 edge2 = Vector3(v2.x - v0.x, v2.y - v0.y, 0);
+    return edge1.cross(edge2).z == 0.0f ? TriangleTest::Degenerate : TriangleTest::BackFace;
+}
+
+Renderer::TriangleTest Renderer::testOutcodes(unsigned char outcode0, unsigned char outcode1,
+                                              unsigned char outcode2) const {
+    unsigned char outside = outcode0 & outcode1 & outcode2 & CLIP_PLANES;
+    if (outside == 0) return TriangleTest::Visible;
+    return (outside & CLIP_NEAR) ? TriangleTest::BehindCamera : TriangleTest::OffScreen;
+}
+
+void Renderer::countCulledTriangle(TriangleTest reason) {
+#if FRAME_STATS
+    switch (reason) {
+        case TriangleTest::BehindCamera: ++frameStats.trianglesBehindCamera; break;
+        case TriangleTest::OffScreen:    ++frameStats.trianglesOffScreen; break;
+        case TriangleTest::BackFace:     ++frameStats.trianglesBackFacing; break;
+        case TriangleTest::Degenerate:   ++frameStats.trianglesDegenerate; break;
+        case TriangleTest::Visible:      break;
+    }
+#else
+    (void)reason;
+#endif
+}
+
 // Depth buffer operations
 void Renderer::initZBuffer() {
     zBuffer.resize(screenWidth * screenHeight);
@@ -460,66 +1514,259 @@ Vector3 Renderer::calculateFaceNormal(const Vector3& v0, const Vector3& v1, cons
     return edge1.cross(edge2).normalized();
 }
 
-// Compute vertex lighting using Light's computeColor method
-Color Renderer::computeVertexLighting(const Vector3& worldPos, const Vector3& normal, 
-                                     const Vector3& viewPos, const std::vector<Light>& lights, 
-                                     const Material& material) {
-    Color finalColor(0, 0, 0);
-    Vector3 viewDir = (viewPos - worldPos).normalized();
+// Gouraud shaded triangle rasterization with color interpolation.
+// Coverage uses the exact fixed-point edge functions of setupTriangle(),
+// stepped in integers; depth and color are evaluated from their planes.
+// Pixels are processed in SIMD blocks (8 wide with AVX2, 4 with SSE2) and
+// blocks with no covered pixel are skipped before any depth or color work.
+void Renderer::fillTriangle_Gouraud(const Vector3& v0, const Vector3& v1, const Vector3& v2, 
+                                   const LinearColor& c0, const LinearColor& c1, const LinearColor& c2,
+                                   const ScreenRect& clip, PixelCounters& counters) {
+    TriangleSetup setup;
+    if (!setupTriangle(v0, v1, v2, clip.minX, clip.minY, clip.maxX, clip.maxY, setup)) return;
     
-    // Accumulate lighting from all lights using each Light's computeColor method
-    for (const Light& light : lights) {
-        Color lightContribution = light.computeColor(normal, viewDir, material);
-        finalColor = finalColor + lightContribution;
-    }
+    const int e0Dx = setup.edgeDx[0], e1Dx = setup.edgeDx[1], e2Dx = setup.edgeDx[2];
+    const int e0Dy = setup.edgeDy[0], e1Dy = setup.edgeDy[1], e2Dy = setup.edgeDy[2];
+    const AttributePlane zPlane = setup.makePlane(v0.z, v1.z, v2.z);
+    const AttributePlane rPlane = setup.makePlane(c0.r, c1.r, c2.r);
+    const AttributePlane gPlane = setup.makePlane(c0.g, c1.g, c2.g);
+    const AttributePlane bPlane = setup.makePlane(c0.b, c1.b, c2.b);
     
-    return finalColor;
-}
-
-// Gouraud shaded triangle rasterization with color interpolation
-void Renderer::fillTriangle_Gouraud(const Vector3& v0, const Vector3& v1, const Vector3& v2, 
-                                   const Color& c0, const Color& c1, const Color& c2) {
-    // Convert to integer coordinates
-    int x0 = static_cast<int>(v0.x), y0 = static_cast<int>(v0.y);
-    int x1 = static_cast<int>(v1.x), y1 = static_cast<int>(v1.y);
-    int x2 = static_cast<int>(v2.x), y2 = static_cast<int>(v2.y);
-    
-    // Find bounding box
-    int minX = std::max(0, std::min({x0, x1, x2}));
-    int maxX = std::min(screenWidth - 1, std::max({x0, x1, x2}));
-    int minY = std::max(0, std::min({y0, y1, y2}));
-    int maxY = std::min(screenHeight - 1, std::max({y0, y1, y2}));
-    
-    // Precompute triangle area for barycentric coordinates
-    float area = static_cast<float>((x1 - x0) * (y2 - y0) - (x2 - x0) * (y1 - y0));
-    if (std::abs(area) < 0.001f) return; // Degenerate triangle
-    
-    // Scanline fill with barycentric interpolation
-    for (int y = minY; y <= maxY; ++y) {
-        for (int x = minX; x <= maxX; ++x) {
-            // Calculate barycentric coordinates
-            float w0 = static_cast<float>((x1 - x) * (y2 - y) - (x2 - x) * (y1 - y)) / area;
-            float w1 = static_cast<float>((x2 - x) * (y0 - y) - (x0 - x) * (y2 - y)) / area;
-            float w2 = 1.0f - w0 - w1;
+#if defined(__AVX2__)
+    const __m256i e0Lanes = _mm256_setr_epi32(0, e0Dx, 2 * e0Dx, 3 * e0Dx, 4 * e0Dx, 5 * e0Dx, 6 * e0Dx, 7 * e0Dx);
+    const __m256i e1Lanes = _mm256_setr_epi32(0, e1Dx, 2 * e1Dx, 3 * e1Dx, 4 * e1Dx, 5 * e1Dx, 6 * e1Dx, 7 * e1Dx);
+    const __m256i e2Lanes = _mm256_setr_epi32(0, e2Dx, 2 * e2Dx, 3 * e2Dx, 4 * e2Dx, 5 * e2Dx, 6 * e2Dx, 7 * e2Dx);
+    const __m256i e0Block = _mm256_set1_epi32(8 * e0Dx);
+    const __m256i e1Block = _mm256_set1_epi32(8 * e1Dx);
+    const __m256i e2Block = _mm256_set1_epi32(8 * e2Dx);
+    const __m256 laneOffsets = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+    const __m256 zOrigin = _mm256_set1_ps(zPlane.origin), zDx = _mm256_set1_ps(zPlane.dx);
+    const __m256 rOrigin = _mm256_set1_ps(rPlane.origin), rDx = _mm256_set1_ps(rPlane.dx);
+    const __m256 gOrigin = _mm256_set1_ps(gPlane.origin), gDx = _mm256_set1_ps(gPlane.dx);
+    const __m256 bOrigin = _mm256_set1_ps(bPlane.origin), bDx = _mm256_set1_ps(bPlane.dx);
+    const int simdWidth = 8;
+#elif defined(__SSE2__)
+    const __m128i e0Lanes = _mm_setr_epi32(0, e0Dx, 2 * e0Dx, 3 * e0Dx);
+    const __m128i e1Lanes = _mm_setr_epi32(0, e1Dx, 2 * e1Dx, 3 * e1Dx);
+    const __m128i e2Lanes = _mm_setr_epi32(0, e2Dx, 2 * e2Dx, 3 * e2Dx);
+    const __m128i e0Block = _mm_set1_epi32(4 * e0Dx);
+    const __m128i e1Block = _mm_set1_epi32(4 * e1Dx);
+    const __m128i e2Block = _mm_set1_epi32(4 * e2Dx);
+    const __m128 laneOffsets = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+    const __m128 zOrigin = _mm_set1_ps(zPlane.origin), zDx = _mm_set1_ps(zPlane.dx);
+    const __m128 rOrigin = _mm_set1_ps(rPlane.origin), rDx = _mm_set1_ps(rPlane.dx);
+    const __m128 gOrigin = _mm_set1_ps(gPlane.origin), gDx = _mm_set1_ps(gPlane.dx);
+    const __m128 bOrigin = _mm_set1_ps(bPlane.origin), bDx = _mm_set1_ps(bPlane.dx);
+    const int simdWidth = 4;
+#endif
+    
+    float* red = colorBuffer.getRed();
+    float* green = colorBuffer.getGreen();
+    float* blue = colorBuffer.getBlue();
+    
+    // Shade one row segment; the edge values are those at (xStart, y)
+    auto rasterizeSpan = [&](int y, int xStart, int xEnd, int e0Row, int e1Row, int e2Row) {
+        int rowIndex = y * screenWidth;
+        int x = xStart;
+        
+#if defined(__AVX2__)
+        __m256i e0v = _mm256_add_epi32(_mm256_set1_epi32(e0Row), e0Lanes);
+        __m256i e1v = _mm256_add_epi32(_mm256_set1_epi32(e1Row), e1Lanes);
+        __m256i e2v = _mm256_add_epi32(_mm256_set1_epi32(e2Row), e2Lanes);
+        const __m256 zRow = _mm256_set1_ps(zPlane.rowTerm(y));
+        
+        for (; x + simdWidth - 1 <= xEnd; x += simdWidth) {
+            // A pixel is covered when no edge value has its sign bit set
+            __m256i edgeSigns = _mm256_or_si256(_mm256_or_si256(e0v, e1v), e2v);
+            int coverMask = ~_mm256_movemask_ps(_mm256_castsi256_ps(edgeSigns)) & 0xFF;
             
-            // Check if point is inside triangle
-            if (w0 >= 0.0f && w1 >= 0.0f && w2 >= 0.0f) {
-                // Interpolate depth
-                float depth = w0 * v0.z + w1 * v1.z + w2 * v2.z;
+            if (coverMask != 0) {
+                // Plane offsets of the block's pixels (the same values at() would use)
+                __m256 xOffset = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(x - zPlane.referenceX)), laneOffsets);
+                
+                // Depth test against the z-buffer
+                __m256 depth = _mm256_add_ps(_mm256_add_ps(zOrigin, _mm256_mul_ps(xOffset, zDx)), zRow);
+                int index = rowIndex + x;
+                __m256 zOld = _mm256_loadu_ps(&zBuffer[index]);
+                __m256 covered = _mm256_castsi256_ps(_mm256_cmpgt_epi32(edgeSigns, _mm256_set1_epi32(-1)));
+                __m256 writeMask = _mm256_and_ps(covered, _mm256_cmp_ps(depth, zOld, _CMP_LT_OQ));
+                int writeBits = _mm256_movemask_ps(writeMask);
+                FRAME_STATS_ADD(counters.tested, __builtin_popcount(coverMask));
+                FRAME_STATS_ADD(counters.passed, __builtin_popcount(writeBits));
                 
-                // Depth test
-                if (depthTest(x, y, depth)) {
-                    // Interpolate color using barycentric coordinates
-                    unsigned char r = static_cast<unsigned char>(
-                        std::min(255.0f, w0 * c0.r + w1 * c1.r + w2 * c2.r));
-                    unsigned char g = static_cast<unsigned char>(
-                        std::min(255.0f, w0 * c0.g + w1 * c1.g + w2 * c2.g));
-                    unsigned char b = static_cast<unsigned char>(
-                        std::min(255.0f, w0 * c0.b + w1 * c1.b + w2 * c2.b));
+                if (writeBits != 0) {
+                    // Interpolate color for the whole block and blend it into the buffers
+                    __m256 r = _mm256_add_ps(_mm256_add_ps(rOrigin, _mm256_mul_ps(xOffset, rDx)), _mm256_set1_ps(rPlane.rowTerm(y)));
+                    __m256 g = _mm256_add_ps(_mm256_add_ps(gOrigin, _mm256_mul_ps(xOffset, gDx)), _mm256_set1_ps(gPlane.rowTerm(y)));
+                    __m256 b = _mm256_add_ps(_mm256_add_ps(bOrigin, _mm256_mul_ps(xOffset, bDx)), _mm256_set1_ps(bPlane.rowTerm(y)));
                     
-                    setPixel(x, y, Color(r, g, b));
+                    _mm256_storeu_ps(&zBuffer[index], _mm256_blendv_ps(zOld, depth, writeMask));
+                    _mm256_storeu_ps(red + index, _mm256_blendv_ps(_mm256_loadu_ps(red + index), r, writeMask));
+                    _mm256_storeu_ps(green + index, _mm256_blendv_ps(_mm256_loadu_ps(green + index), g, writeMask));
+                    _mm256_storeu_ps(blue + index, _mm256_blendv_ps(_mm256_loadu_ps(blue + index), b, writeMask));
                 }
             }
+            
+            e0v = _mm256_add_epi32(e0v, e0Block);
+            e1v = _mm256_add_epi32(e1v, e1Block);
+            e2v = _mm256_add_epi32(e2v, e2Block);
         }
-    }
+#elif defined(__SSE2__)
+        __m128i e0v = _mm_add_epi32(_mm_set1_epi32(e0Row), e0Lanes);
+        __m128i e1v = _mm_add_epi32(_mm_set1_epi32(e1Row), e1Lanes);
+        __m128i e2v = _mm_add_epi32(_mm_set1_epi32(e2Row), e2Lanes);
+        const __m128 zRow = _mm_set1_ps(zPlane.rowTerm(y));
+        
+        for (; x + simdWidth - 1 <= xEnd; x += simdWidth) {
+            // A pixel is covered when no edge value has its sign bit set
+            __m128i edgeSigns = _mm_or_si128(_mm_or_si128(e0v, e1v), e2v);
+            int coverMask = ~_mm_movemask_ps(_mm_castsi128_ps(edgeSigns)) & 0xF;
+            
+            if (coverMask != 0) {
+                // Plane offsets of the block's pixels (the same values at() would use)
+                __m128 xOffset = _mm_add_ps(_mm_set1_ps(static_cast<float>(x - zPlane.referenceX)), laneOffsets);
+                
+                // Depth test against the z-buffer
+                __m128 depth = _mm_add_ps(_mm_add_ps(zOrigin, _mm_mul_ps(xOffset, zDx)), zRow);
+                int index = rowIndex + x;
+                __m128 zOld = _mm_loadu_ps(&zBuffer[index]);
+                __m128 covered = _mm_castsi128_ps(_mm_cmpgt_epi32(edgeSigns, _mm_set1_epi32(-1)));
+                __m128 writeMask = _mm_and_ps(covered, _mm_cmplt_ps(depth, zOld));
+                int writeBits = _mm_movemask_ps(writeMask);
+                FRAME_STATS_ADD(counters.tested, __builtin_popcount(coverMask));
+                FRAME_STATS_ADD(counters.passed, __builtin_popcount(writeBits));
+                
+                if (writeBits != 0) {
+                    // Interpolate color for the whole block and blend it into the buffers
+                    __m128 r = _mm_add_ps(_mm_add_ps(rOrigin, _mm_mul_ps(xOffset, rDx)), _mm_set1_ps(rPlane.rowTerm(y)));
+                    __m128 g = _mm_add_ps(_mm_add_ps(gOrigin, _mm_mul_ps(xOffset, gDx)), _mm_set1_ps(gPlane.rowTerm(y)));
+                    __m128 b = _mm_add_ps(_mm_add_ps(bOrigin, _mm_mul_ps(xOffset, bDx)), _mm_set1_ps(bPlane.rowTerm(y)));
+                    
+                    auto blend = [writeMask](__m128 old, __m128 value) {
+                        return _mm_or_ps(_mm_and_ps(writeMask, value), _mm_andnot_ps(writeMask, old));
+                    };
+                    _mm_storeu_ps(&zBuffer[index], blend(zOld, depth));
+                    _mm_storeu_ps(red + index, blend(_mm_loadu_ps(red + index), r));
+                    _mm_storeu_ps(green + index, blend(_mm_loadu_ps(green + index), g));
+                    _mm_storeu_ps(blue + index, blend(_mm_loadu_ps(blue + index), b));
+                }
+            }
+            
+            e0v = _mm_add_epi32(e0v, e0Block);
+            e1v = _mm_add_epi32(e1v, e1Block);
+            e2v = _mm_add_epi32(e2v, e2Block);
+        }
+#endif
+        
+        // Scalar path for the remainder of the row (or the whole row without SIMD)
+        int e0 = e0Row + (x - xStart) * e0Dx;
+        int e1 = e1Row + (x - xStart) * e1Dx;
+        int e2 = e2Row + (x - xStart) * e2Dx;
+        for (; x <= xEnd; ++x, e0 += e0Dx, e1 += e1Dx, e2 += e2Dx) {
+            if ((e0 | e1 | e2) < 0) continue; // Outside the triangle
+            
+            float depth = zPlane.at(x, y);
+            int index = rowIndex + x;
+            FRAME_STATS_ADD(counters.tested, 1);
+            if (depth < zBuffer[index]) {
+                FRAME_STATS_ADD(counters.passed, 1);
+                zBuffer[index] = depth;
+                red[index] = rPlane.at(x, y);
+                green[index] = gPlane.at(x, y);
+                blue[index] = bPlane.at(x, y);
+            }
+        }
+    };
+    
+    // Walk the bounding box in 8x8 blocks, skipping those entirely outside the triangle
+    forEachBlock(setup, [&](int blockX, int blockY, int blockMaxX, int blockMaxY, int e0, int e1, int e2) {
+        for (int y = blockY; y <= blockMaxY; ++y, e0 += e0Dy, e1 += e1Dy, e2 += e2Dy) {
+            rasterizeSpan(y, blockX, blockMaxX, e0, e1, e2);
+        }
+    });
+}
+
+// Textured triangle: the interpolated lit color is modulated by a bilinear
+// texture sample. Texture coordinates are perspective-correct: u/w, v/w and 1/w
+// are linear in screen space, so they are interpolated like the colors and
+// divided per pixel. Pixels are shaded in 2x2 quads and the mip level is
+// picked once per quad from the coordinate differences across it (pixels of a
+// quad outside the triangle still provide coordinates, but are not written).
+void Renderer::fillTriangle_Textured(const Vector3& v0, const Vector3& v1, const Vector3& v2,
+                                    const LinearColor& c0, const LinearColor& c1, const LinearColor& c2,
+                                    const Vector3& t0, const Vector3& t1, const Vector3& t2, const Texture& texture,
+                                    const ScreenRect& clip, PixelCounters& counters) {
+    // Quads start on even pixels. Tile bounds are even too, so no quad straddles
+    // two tiles and the serial and tiled paths pick the same levels.
+    TriangleSetup setup;
+    if (!setupTriangle(v0, v1, v2, clip.minX, clip.minY, clip.maxX, clip.maxY, setup, 2)) return;
+    
+    const int e0Dx = setup.edgeDx[0], e1Dx = setup.edgeDx[1], e2Dx = setup.edgeDx[2];
+    const int e0Dy = setup.edgeDy[0], e1Dy = setup.edgeDy[1], e2Dy = setup.edgeDy[2];
+    const AttributePlane zPlane = setup.makePlane(v0.z, v1.z, v2.z);
+    const AttributePlane rPlane = setup.makePlane(c0.r, c1.r, c2.r);
+    const AttributePlane gPlane = setup.makePlane(c0.g, c1.g, c2.g);
+    const AttributePlane bPlane = setup.makePlane(c0.b, c1.b, c2.b);
+    const AttributePlane uPlane = setup.makePlane(t0.x, t1.x, t2.x);     // u / w
+    const AttributePlane vPlane = setup.makePlane(t0.y, t1.y, t2.y);     // v / w
+    const AttributePlane qPlane = setup.makePlane(t0.z, t1.z, t2.z);     // 1 / w
+    
+    float* red = colorBuffer.getRed();
+    float* green = colorBuffer.getGreen();
+    float* blue = colorBuffer.getBlue();
+    
+    // Shade the quad with its top-left pixel at (x, y); the edge values are those at (x, y)
+    auto shadeQuad = [&](int x, int y, int e0, int e1, int e2) {
+        int coverMask = 0;
+        for (int k = 0; k < 4; ++k) {
+            int dx = k & 1, dy = k >> 1;
+            int w0 = e0 + dx * e0Dx + dy * e0Dy;
+            int w1 = e1 + dx * e1Dx + dy * e1Dy;
+            int w2 = e2 + dx * e2Dx + dy * e2Dy;
+            if ((w0 | w1 | w2) >= 0 && x + dx <= setup.maxX && y + dy <= setup.maxY) {
+                coverMask |= 1 << k;
+            }
+        }
+        if (coverMask == 0) return;
+        
+        // Perspective-correct texture coordinates of all four pixels
+        float u[4], v[4];
+        for (int k = 0; k < 4; ++k) {
+            int px = x + (k & 1), py = y + (k >> 1);
+            float w = 1.0f / qPlane.at(px, py);
+            u[k] = uPlane.at(px, py) * w;
+            v[k] = vPlane.at(px, py) * w;
+        }
+        int level = texture.selectLevel(u[1] - u[0], v[1] - v[0], u[2] - u[0], v[2] - v[0]);
+        
+        for (int k = 0; k < 4; ++k) {
+            if (!(coverMask & (1 << k))) continue;
+            
+            int px = x + (k & 1), py = y + (k >> 1);
+            float depth = zPlane.at(px, py);
+            int index = py * screenWidth + px;
+            FRAME_STATS_ADD(counters.tested, 1);
+            if (depth < zBuffer[index]) {
+                FRAME_STATS_ADD(counters.passed, 1);
+                zBuffer[index] = depth;
+                LinearColor texel = texture.sample(level, u[k], v[k]);
+                red[index] = rPlane.at(px, py) * texel.r;
+                green[index] = gPlane.at(px, py) * texel.g;
+                blue[index] = bPlane.at(px, py) * texel.b;
+            }
+        }
+    };
+    
+    // Walk the bounding box in 8x8 blocks of whole quads, skipping blocks
+    // entirely outside the triangle
+    forEachBlock(setup, [&](int blockX, int blockY, int blockMaxX, int blockMaxY, int e0Block, int e1Block, int e2Block) {
+        for (int y = blockY; y <= blockMaxY; y += 2) {
+            int e0 = e0Block + (y - blockY) * e0Dy;
+            int e1 = e1Block + (y - blockY) * e1Dy;
+            int e2 = e2Block + (y - blockY) * e2Dy;
+            for (int x = blockX; x <= blockMaxX; x += 2, e0 += 2 * e0Dx, e1 += 2 * e1Dx, e2 += 2 * e2Dx) {
+                shadeQuad(x, y, e0, e1, e2);
+            }
+        }
+    });
 }
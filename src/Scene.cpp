@@ -0,0 +1,224 @@
+#include "Scene.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+
+static float axisValue(const Vector3& v, int axis) {
+    return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+Scene::Scene() : triangleCount(0), needsRebuild(false) {}
+
+size_t Scene::addMesh(const Mesh& mesh) {
+    meshes.push_back(mesh);
+    needsRebuild = true;
+    return meshes.size() - 1;
+}
+
+void Scene::reserve(size_t meshCount) {
+    meshes.reserve(meshCount);
+}
+
+void Scene::clear() {
+    meshes.clear();
+    worldBounds.clear();
+    meshVersions.clear();
+    meshTriangles.clear();
+    triangleCount = 0;
+    nodes.clear();
+    meshOrder.clear();
+    leafOfMesh.clear();
+    touchedMeshes.clear();
+    touched.clear();
+    childMeshes.clear();
+    isChildMesh.clear();
+    needsRebuild = false;
+}
+
+Mesh& Scene::getMesh(size_t index) {
+    // Remember the mesh so update() only has to check what may have changed
+    if (!needsRebuild && !touched[index]) {
+        touched[index] = true;
+        touchedMeshes.push_back(index);
+    }
+    return meshes[index];
+}
+
+void Scene::update() {
+    TRACE_SCOPE("Scene::update");
+    if (needsRebuild) {
+        rebuild();
+        return;
+    }
+
+    for (size_t index : touchedMeshes) {
+        touched[index] = false;
+
+        // The mesh may have been attached to a hierarchy
+        if (!isChildMesh[index] && meshes[index].getTransform().getParent()) {
+            isChildMesh[index] = true;
+            childMeshes.push_back(index);
+        }
+        refitMesh(index);
+    }
+    touchedMeshes.clear();
+
+    // Ancestor nodes may have moved these (only dirty subtrees are recomputed)
+    for (size_t index : childMeshes) {
+        refitMesh(index);
+    }
+}
+
+void Scene::refitMesh(size_t index) {
+    const Mesh& mesh = meshes[index];
+    unsigned int version = mesh.getBoundsVersion();
+    if (version == meshVersions[index]) return;
+
+    meshVersions[index] = version;
+    triangleCount = triangleCount - meshTriangles[index] + mesh.getTriangleCount();
+    meshTriangles[index] = mesh.getTriangleCount();
+    worldBounds[index] = mesh.getWorldBounds();
+    refitLeaf(leafOfMesh[index]);
+}
+
+void Scene::rebuild() {
+    size_t meshCount = meshes.size();
+
+    worldBounds.resize(meshCount);
+    meshVersions.resize(meshCount);
+    meshTriangles.resize(meshCount);
+    triangleCount = 0;
+    for (size_t i = 0; i < meshCount; ++i) {
+        worldBounds[i] = meshes[i].getWorldBounds();
+        meshVersions[i] = meshes[i].getBoundsVersion();
+        meshTriangles[i] = meshes[i].getTriangleCount();
+        triangleCount += meshTriangles[i];
+    }
+
+    meshOrder.resize(meshCount);
+    for (size_t i = 0; i < meshCount; ++i) {
+        meshOrder[i] = static_cast<unsigned int>(i);
+    }
+    leafOfMesh.assign(meshCount, -1);
+
+    nodes.clear();
+    nodes.reserve(2 * (meshCount / LEAF_SIZE + 1));
+    if (meshCount > 0) {
+        buildNode(0, static_cast<unsigned int>(meshCount), -1);
+    }
+
+    touched.assign(meshCount, false);
+    touchedMeshes.clear();
+    isChildMesh.assign(meshCount, false);
+    childMeshes.clear();
+    for (size_t i = 0; i < meshCount; ++i) {
+        if (meshes[i].getTransform().getParent()) {
+            isChildMesh[i] = true;
+            childMeshes.push_back(i);
+        }
+    }
+    needsRebuild = false;
+}
+
+int Scene::buildNode(unsigned int first, unsigned int count, int parent) {
+    int index = static_cast<int>(nodes.size());
+    nodes.push_back(Node());
+
+    Node node;
+    node.left = -1;
+    node.right = -1;
+    node.parent = parent;
+    node.first = first;
+    node.count = count;
+    for (unsigned int i = first; i < first + count; ++i) {
+        node.bounds.expand(worldBounds[meshOrder[i]]);
+    }
+
+    if (count <= LEAF_SIZE) {
+        for (unsigned int i = first; i < first + count; ++i) {
+            leafOfMesh[meshOrder[i]] = index;
+        }
+        nodes[index] = node;
+        return index;
+    }
+
+    // Split at the median centroid along the axis where the centroids spread the most
+    AABB centroidBounds;
+    for (unsigned int i = first; i < first + count; ++i) {
+        centroidBounds.expand(worldBounds[meshOrder[i]].getCenter());
+    }
+    Vector3 spread = centroidBounds.max - centroidBounds.min;
+    int axis = 0;
+    if (spread.y > spread.x) axis = 1;
+    if (spread.z > axisValue(spread, axis)) axis = 2;
+
+    unsigned int middle = first + count / 2;
+    std::nth_element(meshOrder.begin() + first, meshOrder.begin() + middle, meshOrder.begin() + first + count,
+                     [&](unsigned int a, unsigned int b) {
+                         return axisValue(worldBounds[a].getCenter(), axis) <
+                                axisValue(worldBounds[b].getCenter(), axis);
+                     });
+
+    // Children are appended to `nodes`, so only touch this node by index afterwards
+    nodes[index] = node;
+    int left = buildNode(first, middle - first, index);
+    int right = buildNode(middle, first + count - middle, index);
+    nodes[index].left = left;
+    nodes[index].right = right;
+    return index;
+}
+
+void Scene::refitLeaf(int nodeIndex) {
+    Node& leaf = nodes[nodeIndex];
+    leaf.bounds = AABB();
+    for (unsigned int i = leaf.first; i < leaf.first + leaf.count; ++i) {
+        leaf.bounds.expand(worldBounds[meshOrder[i]]);
+    }
+
+    // Propagate to the root; bounds may shrink as well as grow
+    for (int parent = leaf.parent; parent != -1; parent = nodes[parent].parent) {
+        Node& node = nodes[parent];
+        node.bounds = nodes[node.left].bounds;
+        node.bounds.expand(nodes[node.right].bounds);
+    }
+}
+
+void Scene::queryFrustum(const Frustum& frustum, std::vector<size_t>& meshIndices) const {
+    TRACE_SCOPE("Scene::queryFrustum");
+    if (nodes.empty()) return;
+    size_t start = meshIndices.size();
+
+    // Median splits keep the tree balanced, so its depth stays far below the stack size
+    int stack[64];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const Node& node = nodes[stack[--stackSize]];
+
+        Frustum::TestResult result = frustum.testAABB(node.bounds);
+        if (result == Frustum::OUTSIDE) continue;
+
+        if (result == Frustum::INSIDE) {
+            // Whole subtree visible: no further tests needed
+            for (unsigned int i = node.first; i < node.first + node.count; ++i) {
+                meshIndices.push_back(meshOrder[i]);
+            }
+        } else if (node.left == -1) {
+            for (unsigned int i = node.first; i < node.first + node.count; ++i) {
+                if (frustum.testAABB(worldBounds[meshOrder[i]]) != Frustum::OUTSIDE) {
+                    meshIndices.push_back(meshOrder[i]);
+                }
+            }
+        } else {
+            stack[stackSize++] = node.left;
+            stack[stackSize++] = node.right;
+        }
+    }
+
+    // Keep the scene's submission order
+    std::sort(meshIndices.begin() + start, meshIndices.end());
+}
+
+AABB Scene::getBounds() const {
+    return nodes.empty() ? AABB() : nodes[0].bounds;
+}
@@ -0,0 +1,297 @@
+#include "Texture.hpp"
+#include "Trace.hpp"
+#ifndef HEADLESS
+#include <SFML/Graphics.hpp>
+#endif
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+namespace {
+
+// Largest side accepted for level 0 (after rounding up to a power of two)
+const int MAX_TEXTURE_SIZE = 1 << 14;
+
+// Texture coordinates beyond this are wrapped to [0, 1) before sampling, so
+// texel positions stay well inside the int range (and float precision)
+const float MAX_UNWRAPPED_COORDINATE = 1024.0f;
+
+int roundUpToPowerOfTwo(int value) {
+    int power = 1;
+    while (power < value) power <<= 1;
+    return power;
+}
+
+int log2OfPowerOfTwo(int value) {
+    int bits = 0;
+    while ((1 << bits) < value) ++bits;
+    return bits;
+}
+
+// Morton bits of one coordinate: its low `shared` bits are interleaved with the
+// other coordinate's (starting at bit `first`, 0 for x and 1 for y), the rest
+// are packed above them
+std::uint32_t spreadBits(int value, int bits, int shared, int first) {
+    std::uint32_t result = 0;
+    for (int i = 0; i < bits; ++i) {
+        if (value & (1 << i)) {
+            result |= 1u << (i < shared ? 2 * i + first : shared + i);
+        }
+    }
+    return result;
+}
+
+// Copy of a row-major, top-row-first image resized to width x height
+// (bilinear in linear light, clamped at the edges) with its rows in bottom-first order
+std::vector<std::uint32_t> resampleFlipped(const std::uint32_t* rgba, int sourceWidth, int sourceHeight,
+                                           int width, int height) {
+    std::vector<std::uint32_t> result(static_cast<size_t>(width) * height);
+    if (width == sourceWidth && height == sourceHeight) {
+        for (int y = 0; y < height; ++y) {
+            std::copy(rgba + static_cast<size_t>(height - 1 - y) * width,
+                      rgba + static_cast<size_t>(height - y) * width,
+                      result.begin() + static_cast<size_t>(y) * width);
+        }
+        return result;
+    }
+
+    const float* decode = LinearColor::getSRGBDecodeTable();
+    float scaleX = static_cast<float>(sourceWidth) / width;
+    float scaleY = static_cast<float>(sourceHeight) / height;
+    for (int y = 0; y < height; ++y) {
+        float sy = std::min(std::max((y + 0.5f) * scaleY - 0.5f, 0.0f), sourceHeight - 1.0f);
+        int y0 = static_cast<int>(sy);
+        int y1 = std::min(y0 + 1, sourceHeight - 1);
+        float fy = sy - y0;
+        const std::uint32_t* row0 = rgba + static_cast<size_t>(sourceHeight - 1 - y0) * sourceWidth;
+        const std::uint32_t* row1 = rgba + static_cast<size_t>(sourceHeight - 1 - y1) * sourceWidth;
+
+        for (int x = 0; x < width; ++x) {
+            float sx = std::min(std::max((x + 0.5f) * scaleX - 0.5f, 0.0f), sourceWidth - 1.0f);
+            int x0 = static_cast<int>(sx);
+            int x1 = std::min(x0 + 1, sourceWidth - 1);
+            float fx = sx - x0;
+
+            std::uint32_t texel = 0;
+            for (int shift = 0; shift < 24; shift += 8) {
+                float top = decode[(row0[x0] >> shift) & 0xFF] * (1.0f - fx) + decode[(row0[x1] >> shift) & 0xFF] * fx;
+                float bottom = decode[(row1[x0] >> shift) & 0xFF] * (1.0f - fx) + decode[(row1[x1] >> shift) & 0xFF] * fx;
+                texel |= static_cast<std::uint32_t>(LinearColor::encodeSRGB(top * (1.0f - fy) + bottom * fy)) << shift;
+            }
+            float topAlpha = (row0[x0] >> 24) * (1.0f - fx) + (row0[x1] >> 24) * fx;
+            float bottomAlpha = (row1[x0] >> 24) * (1.0f - fx) + (row1[x1] >> 24) * fx;
+            texel |= static_cast<std::uint32_t>(topAlpha * (1.0f - fy) + bottomAlpha * fy + 0.5f) << 24;
+            result[static_cast<size_t>(y) * width + x] = texel;
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+Texture::Texture() : decodeTable(LinearColor::getSRGBDecodeTable()) {}
+
+bool Texture::create(int width, int height, const std::uint32_t* rgba) {
+    TRACE_SCOPE("Texture::create");
+    levels.clear();
+    texels.clear();
+    if (width <= 0 || height <= 0 || !rgba) {
+        return false;
+    }
+
+    int levelWidth = roundUpToPowerOfTwo(width);
+    int levelHeight = roundUpToPowerOfTwo(height);
+    if (levelWidth > MAX_TEXTURE_SIZE || levelHeight > MAX_TEXTURE_SIZE) {
+        return false;
+    }
+    buildLevels(levelWidth, levelHeight, resampleFlipped(rgba, width, height, levelWidth, levelHeight));
+    return true;
+}
+
+void Texture::buildLevels(int width, int height, std::vector<std::uint32_t> image) {
+    const float* decode = LinearColor::getSRGBDecodeTable();
+    std::vector<std::uint32_t> next;
+    for (;;) {
+        Level level;
+        level.width = width;
+        level.height = height;
+        level.offset = texels.size();
+
+        // Swizzle the level into Morton order
+        int widthBits = log2OfPowerOfTwo(width);
+        int heightBits = log2OfPowerOfTwo(height);
+        int shared = std::min(widthBits, heightBits);
+        level.xBits.resize(width);
+        level.yBits.resize(height);
+        for (int x = 0; x < width; ++x) level.xBits[x] = spreadBits(x, widthBits, shared, 0);
+        for (int y = 0; y < height; ++y) level.yBits[y] = spreadBits(y, heightBits, shared, 1);
+
+        texels.resize(level.offset + static_cast<size_t>(width) * height);
+        std::uint32_t* levelTexels = texels.data() + level.offset;
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                levelTexels[level.xBits[x] | level.yBits[y]] = image[static_cast<size_t>(y) * width + x];
+            }
+        }
+        levels.push_back(std::move(level));
+        if (width == 1 && height == 1) break;
+
+        // Next level: average of 2x2 texels in linear light (2x1 once one side is
+        // down to a single texel)
+        int nextWidth = std::max(1, width / 2);
+        int nextHeight = std::max(1, height / 2);
+        next.resize(static_cast<size_t>(nextWidth) * nextHeight);
+        for (int y = 0; y < nextHeight; ++y) {
+            const std::uint32_t* row0 = image.data() + static_cast<size_t>(2 * y) * width;
+            const std::uint32_t* row1 = image.data() + static_cast<size_t>(std::min(2 * y + 1, height - 1)) * width;
+            for (int x = 0; x < nextWidth; ++x) {
+                int x0 = 2 * x;
+                int x1 = std::min(2 * x + 1, width - 1);
+                std::uint32_t texel = 0;
+                for (int shift = 0; shift < 24; shift += 8) {
+                    float sum = decode[(row0[x0] >> shift) & 0xFF] + decode[(row0[x1] >> shift) & 0xFF] +
+                                decode[(row1[x0] >> shift) & 0xFF] + decode[(row1[x1] >> shift) & 0xFF];
+                    texel |= static_cast<std::uint32_t>(LinearColor::encodeSRGB(sum * 0.25f)) << shift;
+                }
+                std::uint32_t alphaSum = (row0[x0] >> 24) + (row0[x1] >> 24) + (row1[x0] >> 24) + (row1[x1] >> 24);
+                texel |= ((alphaSum + 2) / 4) << 24;
+                next[static_cast<size_t>(y) * nextWidth + x] = texel;
+            }
+        }
+        image.swap(next);
+        width = nextWidth;
+        height = nextHeight;
+    }
+}
+
+bool Texture::loadFromPPM(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    // Header: magic, width, height and maximum value, with optional comment lines
+    std::string magic;
+    file >> magic;
+    if (magic != "P6") {
+        return false;
+    }
+    int header[3] = { 0, 0, 0 };
+    for (int& value : header) {
+        file >> std::ws;
+        while (file.peek() == '#') {
+            std::string comment;
+            std::getline(file, comment);
+            file >> std::ws;
+        }
+        file >> value;
+    }
+    int width = header[0], height = header[1], maxValue = header[2];
+    if (!file || width <= 0 || height <= 0 || width > MAX_TEXTURE_SIZE || height > MAX_TEXTURE_SIZE ||
+        maxValue <= 0 || maxValue > 255) {
+        return false;
+    }
+    file.get();     // Single whitespace before the texels
+
+    size_t texelCount = static_cast<size_t>(width) * height;
+    std::vector<unsigned char> rgb(texelCount * 3);
+    if (!file.read(reinterpret_cast<char*>(rgb.data()), static_cast<std::streamsize>(rgb.size()))) {
+        return false;
+    }
+
+    std::vector<std::uint32_t> rgba(texelCount);
+    for (size_t i = 0; i < texelCount; ++i) {
+        std::uint32_t r = rgb[i * 3] * 255u / maxValue;
+        std::uint32_t g = rgb[i * 3 + 1] * 255u / maxValue;
+        std::uint32_t b = rgb[i * 3 + 2] * 255u / maxValue;
+        rgba[i] = r | (g << 8) | (b << 16) | 0xFF000000u;
+    }
+    return create(width, height, rgba.data());
+}
+
+#ifndef HEADLESS
+bool Texture::loadFromFile(const std::string& filename) {
+    sf::Image image;
+    if (!image.loadFromFile(filename)) {
+        return false;
+    }
+
+    // SFML images are RGBA8 from the top row, like Renderer::getPixels
+    sf::Vector2u size = image.getSize();
+    std::vector<std::uint32_t> rgba(static_cast<size_t>(size.x) * size.y);
+    if (rgba.empty()) {
+        return false;
+    }
+    std::memcpy(rgba.data(), image.getPixelsPtr(), rgba.size() * sizeof(std::uint32_t));
+    return create(static_cast<int>(size.x), static_cast<int>(size.y), rgba.data());
+}
+#endif
+
+size_t Texture::getMemoryUsage() const {
+    size_t bytes = texels.size() * sizeof(std::uint32_t);
+    for (const Level& level : levels) {
+        bytes += (level.xBits.size() + level.yBits.size()) * sizeof(std::uint32_t);
+    }
+    return bytes;
+}
+
+int Texture::selectLevel(float dudx, float dvdx, float dudy, float dvdy) const {
+    int maxLevel = getLevelCount() - 1;
+    if (maxLevel <= 0) return 0;
+
+    // Squared texel footprint of a pixel step along x and along y (level 0 texels)
+    float width = static_cast<float>(levels[0].width);
+    float height = static_cast<float>(levels[0].height);
+    float footprintX = dudx * dudx * width * width + dvdx * dvdx * height * height;
+    float footprintY = dudy * dudy * width * width + dvdy * dvdy * height * height;
+    float footprint = std::max(footprintX, footprintY);
+    if (!(footprint > 1.0f)) return 0;     // Magnified (or not a number)
+
+    // log2 of the footprint's side, rounded to the nearest level
+    float lod = 0.5f * std::log2(footprint);
+    if (!(lod < static_cast<float>(maxLevel))) return maxLevel;
+    return static_cast<int>(lod + 0.5f);
+}
+
+LinearColor Texture::sample(int level, float u, float v) const {
+    const Level& mip = levels[level];
+
+    // Texel space with texel centers at integers. Texel indices wrap to the level
+    // below; coordinates too far out for an int are brought back first.
+    if (!(std::fabs(u) < MAX_UNWRAPPED_COORDINATE && std::fabs(v) < MAX_UNWRAPPED_COORDINATE)) {
+        u -= std::floor(u);
+        v -= std::floor(v);
+    }
+    float x = u * mip.width - 0.5f;
+    float y = v * mip.height - 0.5f;
+    float xFloor = std::floor(x);
+    float yFloor = std::floor(y);
+    float fx = x - xFloor;
+    float fy = y - yFloor;
+    int xMask = mip.width - 1;
+    int yMask = mip.height - 1;
+    int x0 = static_cast<int>(xFloor) & xMask;
+    int y0 = static_cast<int>(yFloor) & yMask;
+    int x1 = (x0 + 1) & xMask;
+    int y1 = (y0 + 1) & yMask;
+
+    const std::uint32_t* levelTexels = texels.data() + mip.offset;
+    std::uint32_t t00 = levelTexels[mip.xBits[x0] | mip.yBits[y0]];
+    std::uint32_t t10 = levelTexels[mip.xBits[x1] | mip.yBits[y0]];
+    std::uint32_t t01 = levelTexels[mip.xBits[x0] | mip.yBits[y1]];
+    std::uint32_t t11 = levelTexels[mip.xBits[x1] | mip.yBits[y1]];
+
+    // Texels are sRGB; filter their linear values
+    const float* decode = decodeTable;
+    float w00 = (1.0f - fx) * (1.0f - fy);
+    float w10 = fx * (1.0f - fy);
+    float w01 = (1.0f - fx) * fy;
+    float w11 = fx * fy;
+    auto channel = [&](int shift) {
+        return decode[(t00 >> shift) & 0xFF] * w00 + decode[(t10 >> shift) & 0xFF] * w10 +
+               decode[(t01 >> shift) & 0xFF] * w01 + decode[(t11 >> shift) & 0xFF] * w11;
+    };
+    return LinearColor(channel(0), channel(8), channel(16));
+}
@@ -0,0 +1,91 @@
+#include "ThreadPool.hpp"
+#include "Trace.hpp"
+
+ThreadPool::ThreadPool(size_t threadCount)
+    : currentTask(nullptr), taskCount(0), nextIndex(0),
+      busyWorkers(0), generation(0), stopping(false)
+{
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+        if (threadCount == 0) threadCount = 1;
+    }
+
+    // The caller participates in every parallelFor, so spawn one less
+    for (size_t i = 1; i < threadCount; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& task) {
+    if (count == 0) return;
+
+    // Nothing to share: run inline without touching the workers
+    if (workers.empty() || count == 1) {
+        for (size_t i = 0; i < count; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentTask = &task;
+        taskCount = count;
+        nextIndex.store(0);
+        busyWorkers = workers.size();
+        ++generation;
+    }
+    workAvailable.notify_all();
+
+    runTasks();
+
+    // Wait for every worker to leave the job before the task goes out of scope
+    std::unique_lock<std::mutex> lock(mutex);
+    workFinished.wait(lock, [this] { return busyWorkers == 0; });
+    currentTask = nullptr;
+}
+
+void ThreadPool::workerLoop() {
+    Trace::setThreadName("Pool worker");
+    unsigned long seenGeneration = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            workAvailable.wait(lock, [&] { return stopping || generation != seenGeneration; });
+            if (stopping) return;
+            seenGeneration = generation;
+        }
+
+        runTasks();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --busyWorkers;
+        }
+        workFinished.notify_one();
+    }
+}
+
+void ThreadPool::runTasks() {
+    // currentTask and taskCount are stable until busyWorkers drops to zero
+    const std::function<void(size_t)>& task = *currentTask;
+    size_t count = taskCount;
+
+    size_t i;
+    while ((i = nextIndex.fetch_add(1)) < count) {
+        task(i);
+    }
+}
@@ -0,0 +1,227 @@
+#include "Trace.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> Trace::enabled(false);
+
+namespace {
+
+// Ring buffer slot. Fields are atomics (relaxed, so plain moves on x86) because
+// an export may read a slot while its thread overwrites it.
+struct TraceEvent {
+    std::atomic<const char*> name;
+    std::atomic<uint64_t> start;
+    std::atomic<uint64_t> end;
+};
+
+struct ExportedEvent {
+    const char* name;
+    uint64_t start;
+    uint64_t end;
+};
+
+// Events of one thread. Only that thread writes `events` and `written`.
+struct ThreadBuffer {
+    std::unique_ptr<TraceEvent[]> events;
+    std::atomic<uint64_t> written;          // Events recorded since the buffer was handed out
+    std::atomic<uint64_t> firstKept;        // Events before this were dropped by Trace::clear()
+    unsigned int threadId;                  // Id and name are guarded by the registry mutex
+    std::string threadName;
+
+    ThreadBuffer() : events(new TraceEvent[Trace::CAPACITY]), written(0), firstKept(0), threadId(0) {}
+};
+
+// Events a thread left when it exited, copied out of its ring
+struct ExitedThread {
+    unsigned int threadId;
+    std::string threadName;
+    std::vector<ExportedEvent> events;
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<ThreadBuffer*> buffers;                     // Threads that have recorded and are running
+    std::vector<std::unique_ptr<ThreadBuffer>> freeBuffers; // Rings of exited threads, reused by new ones
+    std::vector<ExitedThread> exitedThreads;                // Until exported or cleared
+    unsigned int nextThreadId = 1;
+};
+
+// Never destroyed, so threads still running at exit can keep recording
+Registry& getRegistry() {
+    static Registry* registry = new Registry();
+    return *registry;
+}
+
+// Copy the kept events of a buffer. The owning thread may keep recording: events
+// it may have overwritten meanwhile are dropped, since writing event `written`
+// reuses the slot of event `written - CAPACITY`.
+void copyEvents(const ThreadBuffer& buffer, std::vector<ExportedEvent>& events) {
+    const uint64_t capacity = Trace::CAPACITY;
+    uint64_t end = buffer.written.load(std::memory_order_acquire);
+    uint64_t begin = std::max(buffer.firstKept.load(std::memory_order_relaxed), end > capacity ? end - capacity : 0);
+    events.clear();
+    for (uint64_t i = begin; i < end; ++i) {
+        const TraceEvent& event = buffer.events[i % capacity];
+        events.push_back(ExportedEvent{ event.name.load(std::memory_order_relaxed),
+                                        event.start.load(std::memory_order_relaxed),
+                                        event.end.load(std::memory_order_relaxed) });
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t writtenAfter = buffer.written.load(std::memory_order_relaxed);
+    uint64_t firstIntact = writtenAfter + 1 > capacity ? writtenAfter + 1 - capacity : 0;
+    if (firstIntact > begin) {
+        events.erase(events.begin(), events.begin() + static_cast<size_t>(std::min<uint64_t>(firstIntact - begin, events.size())));
+    }
+}
+
+// The calling thread's name and buffer. A thread takes a buffer on its first
+// recorded event, so threads that never record cost no ring. On exit its
+// events are copied out and the ring goes back to the free list.
+struct LocalTrace {
+    ThreadBuffer* buffer = nullptr;
+    std::string threadName;
+
+    ~LocalTrace() {
+        if (!buffer) return;
+        ExitedThread exited;
+        copyEvents(*buffer, exited.events);
+
+        Registry& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        if (!exited.events.empty()) {
+            exited.threadId = buffer->threadId;
+            exited.threadName = buffer->threadName;
+            exited.events.shrink_to_fit();
+            registry.exitedThreads.push_back(std::move(exited));
+        }
+        registry.buffers.erase(std::find(registry.buffers.begin(), registry.buffers.end(), buffer));
+        registry.freeBuffers.push_back(std::unique_ptr<ThreadBuffer>(buffer));
+        buffer = nullptr;
+    }
+};
+
+thread_local LocalTrace localTrace;
+
+ThreadBuffer& getLocalBuffer() {
+    if (!localTrace.buffer) {
+        Registry& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        ThreadBuffer* buffer;
+        if (registry.freeBuffers.empty()) {
+            buffer = new ThreadBuffer();
+        } else {
+            buffer = registry.freeBuffers.back().release();
+            registry.freeBuffers.pop_back();
+            buffer->written.store(0, std::memory_order_relaxed);
+            buffer->firstKept.store(0, std::memory_order_relaxed);
+        }
+        buffer->threadId = registry.nextThreadId++;
+        buffer->threadName = localTrace.threadName;
+        registry.buffers.push_back(buffer);
+        localTrace.buffer = buffer;
+    }
+    return *localTrace.buffer;
+}
+
+// JSON string contents (event names are expected to be plain identifiers)
+void writeEscaped(std::ostream& out, const char* text) {
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') out << '\\';
+        if (static_cast<unsigned char>(*c) >= 0x20) out << *c;
+    }
+}
+
+// Thread name metadata, then one complete ("X") event per scope (microseconds)
+void writeThread(std::ostream& out, bool first, unsigned int threadId, const std::string& threadName,
+                 const std::vector<ExportedEvent>& events) {
+    out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+        << threadId << ",\"args\":{\"name\":\"";
+    if (threadName.empty()) {
+        out << "Thread " << threadId;
+    } else {
+        writeEscaped(out, threadName.c_str());
+    }
+    out << "\"}}";
+
+    char timing[64];
+    for (const ExportedEvent& event : events) {
+        out << ",\n{\"name\":\"";
+        writeEscaped(out, event.name);
+        std::snprintf(timing, sizeof(timing), "\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f",
+                      event.start / 1000.0, (event.end - event.start) / 1000.0);
+        out << timing << ",\"pid\":1,\"tid\":" << threadId << "}";
+    }
+}
+
+} // namespace
+
+void Trace::setEnabled(bool enable) {
+    enabled.store(enable, std::memory_order_relaxed);
+}
+
+void Trace::setThreadName(const char* name) {
+    localTrace.threadName = name;
+    if (localTrace.buffer) {
+        std::lock_guard<std::mutex> lock(getRegistry().mutex);
+        localTrace.buffer->threadName = name;
+    }
+}
+
+void Trace::clear() {
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (ThreadBuffer* buffer : registry.buffers) {
+        buffer->firstKept.store(buffer->written.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+    registry.exitedThreads.clear();
+}
+
+uint64_t Trace::now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void Trace::record(const char* name, uint64_t start, uint64_t end) {
+    ThreadBuffer& buffer = getLocalBuffer();
+    uint64_t index = buffer.written.load(std::memory_order_relaxed);
+    TraceEvent& event = buffer.events[index % CAPACITY];
+    event.name.store(name, std::memory_order_relaxed);
+    event.start.store(start, std::memory_order_relaxed);
+    event.end.store(end, std::memory_order_relaxed);
+
+    // Publishes the event to exports
+    buffer.written.store(index + 1, std::memory_order_release);
+}
+
+bool Trace::writeJSON(const std::string& filename) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    std::vector<ExportedEvent> events;
+    for (const ThreadBuffer* buffer : registry.buffers) {
+        copyEvents(*buffer, events);
+        writeThread(file, first, buffer->threadId, buffer->threadName, events);
+        first = false;
+    }
+
+    // Exited threads will not record again, so their events are only exported once
+    for (const ExitedThread& thread : registry.exitedThreads) {
+        writeThread(file, first, thread.threadId, thread.threadName, thread.events);
+        first = false;
+    }
+    registry.exitedThreads.clear();
+    file << "\n]}\n";
+    return file.good();
+}
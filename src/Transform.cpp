@@ -0,0 +1,198 @@
+#include "Transform.hpp"
+#include <algorithm>
+#include <cmath>
+
+static bool sameVector(const Vector3& a, const Vector3& b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+Transform::Transform()
+    : position(0, 0, 0), rotation(0, 0, 0), scale(1, 1, 1), parent(nullptr),
+      localDirty(true), worldDirty(true), worldVersion(0) {}
+
+Transform::~Transform() {
+    detachFromParent();
+    for (Transform* child : children) {
+        child->parent = nullptr;
+        child->markWorldDirty();
+    }
+}
+
+Transform::Transform(const Transform& other)
+    : position(other.position), rotation(other.rotation), scale(other.scale), parent(other.parent),
+      localMatrix(other.localMatrix), worldMatrix(other.worldMatrix),
+      localDirty(other.localDirty), worldDirty(other.worldDirty), worldVersion(other.worldVersion) {
+    // Same parent and local transform, so the cached world matrix stays valid
+    if (parent) {
+        parent->children.push_back(this);
+    }
+}
+
+Transform& Transform::operator=(const Transform& other) {
+    if (this == &other) return *this;
+
+    position = other.position;
+    rotation = other.rotation;
+    scale = other.scale;
+    if (!setParent(other.parent)) {
+        setParent(nullptr); // other's parent is inside this subtree
+    }
+    markLocalDirty();
+    return *this;
+}
+
+Transform::Transform(Transform&& other) noexcept
+    : position(other.position), rotation(other.rotation), scale(other.scale), parent(nullptr),
+      localMatrix(other.localMatrix), worldMatrix(other.worldMatrix),
+      localDirty(other.localDirty), worldDirty(other.worldDirty), worldVersion(other.worldVersion) {
+    replaceInHierarchy(other);
+}
+
+Transform& Transform::operator=(Transform&& other) noexcept {
+    if (this == &other) return *this;
+
+    // Leave the current place in the hierarchy; our children become roots
+    detachFromParent();
+    for (Transform* child : children) {
+        child->parent = nullptr;
+        child->markWorldDirty();
+    }
+    children.clear();
+
+    position = other.position;
+    rotation = other.rotation;
+    scale = other.scale;
+    localMatrix = other.localMatrix;
+    worldMatrix = other.worldMatrix;
+    localDirty = other.localDirty;
+    worldDirty = other.worldDirty;
+
+    // This node is now a different transform: its version must move on
+    worldVersion = std::max(worldVersion, other.worldVersion) + 1;
+
+    replaceInHierarchy(other);
+    return *this;
+}
+
+void Transform::replaceInHierarchy(Transform& other) {
+    // Take other's place under its parent and over its children
+    parent = other.parent;
+    if (parent) {
+        std::replace(parent->children.begin(), parent->children.end(), &other, this);
+    }
+    children = std::move(other.children);
+    for (Transform* child : children) {
+        child->parent = this;
+    }
+
+    other.parent = nullptr;
+    other.children.clear();
+}
+
+void Transform::setPosition(const Vector3& newPosition) {
+    if (sameVector(position, newPosition)) return;
+    position = newPosition;
+    markLocalDirty();
+}
+
+void Transform::setRotation(const Vector3& newRotation) {
+    if (sameVector(rotation, newRotation)) return;
+    rotation = newRotation;
+    markLocalDirty();
+}
+
+void Transform::setScale(const Vector3& newScale) {
+    if (sameVector(scale, newScale)) return;
+    scale = newScale;
+    markLocalDirty();
+}
+
+bool Transform::setParent(Transform* newParent) {
+    if (newParent == parent) return true;
+
+    // Refuse to create a cycle
+    for (const Transform* ancestor = newParent; ancestor; ancestor = ancestor->parent) {
+        if (ancestor == this) return false;
+    }
+
+    detachFromParent();
+    parent = newParent;
+    if (parent) {
+        parent->children.push_back(this);
+    }
+    markWorldDirty();
+    return true;
+}
+
+void Transform::detachFromParent() {
+    if (!parent) return;
+    std::vector<Transform*>& siblings = parent->children;
+    siblings.erase(std::find(siblings.begin(), siblings.end(), this));
+    parent = nullptr;
+}
+
+void Transform::markLocalDirty() {
+    localDirty = true;
+    markWorldDirty();
+}
+
+void Transform::markWorldDirty() {
+    // Dirty nodes already have a dirty subtree
+    if (worldDirty) return;
+    worldDirty = true;
+    for (Transform* child : children) {
+        child->markWorldDirty();
+    }
+}
+
+const Matrix4& Transform::getLocalMatrix() const {
+    if (!localDirty) return localMatrix;
+
+    float cx = std::cos(rotation.x), sx = std::sin(rotation.x);
+    float cy = std::cos(rotation.y), sy = std::sin(rotation.y);
+    float cz = std::cos(rotation.z), sz = std::sin(rotation.z);
+
+    // rotationZ * rotationY
+    float a[3][3] = {
+        { cz * cy, -sz,  cz * sy },
+        { sz * cy,  cz,  sz * sy },
+        { -sy,      0.0f, cy     }
+    };
+
+    // ... * rotationX, then scale the columns and set the translation. Same
+    // result as translation * rotationZ * rotationY * rotationX * scale with
+    // full 4x4 products (the skipped terms are exact zeros).
+    const float scales[3] = { scale.x, scale.y, scale.z };
+    const float translation[3] = { position.x, position.y, position.z };
+    for (int i = 0; i < 3; ++i) {
+        float r0 = a[i][0];
+        float r1 = a[i][1] * cx + a[i][2] * sx;
+        float r2 = a[i][1] * -sx + a[i][2] * cx;
+        localMatrix.m[i][0] = r0 * scales[0];
+        localMatrix.m[i][1] = r1 * scales[1];
+        localMatrix.m[i][2] = r2 * scales[2];
+        localMatrix.m[i][3] = translation[i];
+    }
+    localMatrix.m[3][0] = 0.0f;
+    localMatrix.m[3][1] = 0.0f;
+    localMatrix.m[3][2] = 0.0f;
+    localMatrix.m[3][3] = 1.0f;
+
+    localDirty = false;
+    return localMatrix;
+}
+
+const Matrix4& Transform::getWorldMatrix() const {
+    if (!worldDirty) return worldMatrix;
+
+    // Ancestors are only rebuilt if they are dirty themselves
+    worldMatrix = parent ? parent->getWorldMatrix() * getLocalMatrix() : getLocalMatrix();
+    worldDirty = false;
+    ++worldVersion;
+    return worldMatrix;
+}
+
+unsigned int Transform::getWorldVersion() const {
+    getWorldMatrix();
+    return worldVersion;
+}
@@ -0,0 +1,22 @@
+#include "Vector4.hpp"
+
+Vector4::Vector4(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+
+Vector4::Vector4(const Vector3& v, float w) : x(v.x), y(v.y), z(v.z), w(w) {}
+
+Vector4 Vector4::operator+(const Vector4& other) const {
+    return Vector4(x + other.x, y + other.y, z + other.z, w + other.w);
+}
+
+Vector4 Vector4::operator-(const Vector4& other) const {
+    return Vector4(x - other.x, y - other.y, z - other.z, w - other.w);
+}
+
+Vector4 Vector4::operator*(float scalar) const {
+    return Vector4(x * scalar, y * scalar, z * scalar, w * scalar);
+}
+
+Vector3 Vector4::projected() const {
+    float invW = 1.0f / w;
+    return Vector3(x * invW, y * invW, z * invW);
+}
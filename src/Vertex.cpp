@@ -1,6 +1,10 @@
 #include "Vertex.hpp"
 
-Vertex::Vertex(const Vector3& pos) : position(pos) {
+Vertex::Vertex(const Vector3& pos) : position(pos), normal(0, 0, 0), u(0.0f), v(0.0f) {
     // Simple constructor that initializes the vertex position
-    // Additional properties like color, normal, UV coordinates can be added later
-}
\ No newline at end of file
+    // Additional properties like color can be added later
+}
+
+Vertex::Vertex(const Vector3& pos, const Vector3& normal, float u, float v)
+    : position(pos), normal(normal), u(u), v(v) {
+}
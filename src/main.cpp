@@ -2,8 +2,11 @@
 #include <SFML/Graphics.hpp>
 #include "Vector3.hpp"
 #include "Mesh.hpp"
+#include "MeshCache.hpp"
 #include "Camera.hpp"
 #include "Renderer.hpp"
+#include "FramePipeline.hpp"
+#include "Trace.hpp"
 #include "Light.hpp"
 #include "Material.hpp"
 
@@ -11,6 +14,7 @@ using namespace std;
 
 int main() {
   cout << "3D Graphics Engine - Simple Renderer Test" << endl;
+  Trace::setThreadName("Main");
 
   // Create SFML window
   const int WINDOW_WIDTH = 800;
@@ -34,12 +38,12 @@ int main() {
   
   // Load cube - positioned at center, visible and red
   Mesh cubeMesh;
-  if (cubeMesh.loadFromOBJ("assets/cube.obj")) {
+  if (MeshCache::load("assets/cube.obj", cubeMesh)) {
     cubeMesh.rotateWorldX(2);
     cubeMesh.rotateWorldY(3);
     cubeMesh.setWorldPosition(0.0f, 0.0f, -2.0f);  // Just 2 units in front of camera
     cubeMesh.setWorldScale(1.0f);                   // Normal size first
-    meshes.push_back(cubeMesh);
+    meshes.push_back(cubeMesh);                     // Copies share the geometry
     cout << "✓ Red cube loaded: " << cubeMesh.getVertexCount() << " vertices, " 
          << cubeMesh.getTriangleCount() << " triangles" << endl;
     cout << "  Position: (0, 0, -2), Scale: 1.0" << endl;
@@ -102,6 +106,9 @@ int main() {
   cout << "- H/L: Rotate cube around Y-axis (left/right)" << endl;
   cout << "- J/K: Rotate cube around X-axis (down/up)" << endl;
   cout << "- SPACE: Toggle between Mesh and Lighting rendering" << endl;
+  cout << "- O: Toggle occlusion culling" << endl;
+  cout << "- F: Print frame statistics" << endl;
+  cout << "- T: Start/stop tracing (writes trace.json for ui.perfetto.dev)" << endl;
   cout << "\nStarting render loop..." << endl;
 
   // Manual rotation control variables
@@ -115,9 +122,19 @@ int main() {
   const float movementSpeed = 0.2f; // Camera movement speed
   sf::Clock clock; // For frame timing
   bool useLighting = true; // Start with lighting rendering
+  bool transformChanged = true; // Cube transform needs to be applied
+  bool occlusionCulling = false;
+  bool printStats = false; // Print the next presented frame's statistics
+
+  // Frames are rendered on a separate thread while the previous one is presented
+  // (double buffering). From here on the meshes and the renderer's render state
+  // are only touched by frame functions, which get this frame's input by value.
+  FramePipeline pipeline(renderer, 2);
 
   // Main render loop - continues until window is closed
   while (window.isOpen()) {
+    TRACE_SCOPE("Main loop");
+
     // Process events
     while (auto event = window.pollEvent()) {
       if (event->is<sf::Event::Closed>()) {
@@ -134,70 +151,128 @@ int main() {
           useLighting = !useLighting;
           cout << "Switched to " << (useLighting ? "Lighting" : "Mesh") << " rendering" << endl;
         }
+        else if (keyPressed->scancode == sf::Keyboard::Scancode::O) {
+          occlusionCulling = !occlusionCulling;
+          cout << "Occlusion culling " << (occlusionCulling ? "enabled" : "disabled") << endl;
+        }
+        else if (keyPressed->scancode == sf::Keyboard::Scancode::F) {
+          printStats = true;
+        }
+        else if (keyPressed->scancode == sf::Keyboard::Scancode::T) {
+          if (!Trace::isEnabled()) {
+            Trace::clear();
+            Trace::setEnabled(true);
+            cout << "Tracing started" << endl;
+          } else {
+            Trace::setEnabled(false);
+            bool written = Trace::writeJSON("trace.json");
+            cout << (written ? "Trace written to trace.json" : "Failed to write trace.json") << endl;
+          }
+        }
         // Arrow key controls for camera movement
         else if (keyPressed->scancode == sf::Keyboard::Scancode::Up) {
           // camera.position.z -= cameraSpeed; // Move forward
           positionY -= movementSpeed;
+          transformChanged = true;
           cout << "Camera forward - Z: " << camera.position.z << endl;
         }
         else if (keyPressed->scancode == sf::Keyboard::Scancode::Down) {
           // camera.position.z += cameraSpeed; // Move backward
           positionY += movementSpeed;
+          transformChanged = true;
           cout << "Camera backward - Z: " << camera.position.z << endl;
         }
         else if (keyPressed->scancode == sf::Keyboard::Scancode::Left) {
           // camera.position.x -= cameraSpeed; // Move left
           positionX -= movementSpeed;
+          transformChanged = true;
           cout << "Camera left - X: " << camera.position.x << endl;
         }
         else if (keyPressed->scancode == sf::Keyboard::Scancode::Right) {
           // camera.position.x += cameraSpeed; // Move right
           positionX += movementSpeed;
+          transformChanged = true;
           cout << "Camera right - X: " << camera.position.x << endl;
         }
         // H/L keys for cube rotation around Y-axis
         else if (keyPressed->scancode == sf::Keyboard::Scancode::H) {
           rotationY -= rotationSpeed; // Rotate left around Y-axis
+          transformChanged = true;
           cout << "Cube rotate left - Y: " << rotationY << endl;
         }
         else if (keyPressed->scancode == sf::Keyboard::Scancode::L) {
           rotationY += rotationSpeed; // Rotate right around Y-axis
+          transformChanged = true;
           cout << "Cube rotate right - Y: " << rotationY << endl;
         }
         // J/K keys for cube rotation around X-axis
         else if (keyPressed->scancode == sf::Keyboard::Scancode::J) {
           rotationX += rotationSpeed; // Rotate down around X-axis
+          transformChanged = true;
           cout << "Cube rotate down - X: " << rotationX << endl;
         }
         else if (keyPressed->scancode == sf::Keyboard::Scancode::K) {
           rotationX -= rotationSpeed; // Rotate up around X-axis
+          transformChanged = true;
           cout << "Cube rotate up - X: " << rotationX << endl;
         }
       }
     }
 
-    // Apply user-controlled rotation to the cube
-    for (Mesh& mesh : meshes) {
-      mesh.setWorldRotation(rotationX, rotationY, rotationZ);
-      mesh.setWorldPosition(positionX, positionY, positionZ);
-    }
+    // Apply user-controlled rotation to the cube (only after input changed it,
+    // so the cached world matrices are not rebuilt every frame)
+    bool applyTransform = transformChanged;
+    transformChanged = false;
+    Vector3 rotation(rotationX, rotationY, rotationZ);
+    Vector3 position(positionX, positionY, positionZ);
+
+    const FramePipeline::Frame* frame = pipeline.submit(
+      [&meshes, &lights, &cubeMaterial, camera, useLighting, occlusionCulling, applyTransform, rotation, position]
+      (Renderer& target) {
+        if (applyTransform) {
+          for (Mesh& mesh : meshes) {
+            mesh.setWorldRotation(rotation);
+            mesh.setWorldPosition(position);
+          }
+        }
+        target.setOcclusionCulling(occlusionCulling);
+
+        // Clear renderer
+        target.clear(Color(20, 20, 40)); // Dark blue background
+
+        // Render scene with either lighting or mesh rendering
+        if (useLighting) {
+          target.render_Light(meshes, camera, lights, cubeMaterial);
+        } else {
+          target.render_Mesh(meshes, camera);
+        }
+      });
 
-    // Clear renderer
-    renderer.clear(Color(20, 20, 40)); // Dark blue background
-    
-    // Render scene with either lighting or mesh rendering
-    if (useLighting) {
-      renderer.render_Light(meshes, camera, lights, cubeMaterial);
-    } else {
-      renderer.render_Mesh(meshes, camera);
+    // Present the previous frame while this one renders
+    if (frame) {
+      TRACE_SCOPE("Present");
+      window.clear();
+      renderer.present(window, frame->pixels);
+      window.display();
+
+      if (printStats) {
+        const FrameStats& stats = frame->stats;
+        cout << "Frame " << stats.frame << ": " << stats.getTrianglesDrawn() << "/" << stats.trianglesSubmitted
+             << " triangles drawn (" << stats.trianglesBackFacing << " back-facing, " << stats.trianglesOffScreen
+             << " off-screen), overdraw " << stats.getOverdraw() << ", " << stats.getTotalMs() << " ms (clear "
+             << stats.clearMs << ", transform " << stats.transformMs << ", lighting " << stats.lightingMs
+             << ", raster " << stats.rasterMs << ", resolve " << stats.presentMs << ")" << endl;
+        printStats = false;
+      }
     }
-    
-    // Present to window
-    window.clear();
-    renderer.present(window);
-    window.display();
   }
 
+  FramePipeline::Stats stats = pipeline.getStats();
+  if (stats.frames > 0) {
+    cout << "Frames: " << stats.frames << ", render " << stats.renderMs / stats.frames
+         << " ms, latency " << stats.latencyMs / stats.frames << " ms, waiting " << stats.stallMs / stats.frames
+         << " ms per frame" << endl;
+  }
   cout << "Render loop finished." << endl;
   return 0;
 }
\ No newline at end of file
@@ -0,0 +1,78 @@
+// Converts OBJ files to the binary mesh cache format and reports load times
+// for both paths. With --optimize the mesh is welded and reordered by
+// MeshOptimizer before it is written.
+//
+// Usage: ./mesh_cache [--optimize] input.obj [output.meshbin]
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include "Mesh.hpp"
+#include "MeshCache.hpp"
+#include "MeshOptimizer.hpp"
+#include "ObjParser.hpp"
+
+static double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    bool optimize = argc > 1 && std::string(argv[1]) == "--optimize";
+    int firstPath = optimize ? 2 : 1;
+    if (argc < firstPath + 1 || argc > firstPath + 2) {
+        printf("Usage: %s [--optimize] input.obj [output.meshbin]\n", argv[0]);
+        return 1;
+    }
+
+    std::string objPath = argv[firstPath];
+    std::string cachePath = argc == firstPath + 2 ? argv[firstPath + 1] : MeshCache::getDefaultCachePath(objPath);
+
+    auto start = std::chrono::steady_clock::now();
+    Mesh mesh;
+    ObjParseStats parseStats;
+    if (!mesh.loadFromOBJ(objPath, &parseStats)) {
+        fprintf(stderr, "Failed to load OBJ: %s\n", objPath.c_str());
+        return 1;
+    }
+    double objMs = elapsedMs(start);
+
+    MeshOptimizeStats optimizeStats;
+    double optimizeMs = 0.0;
+    if (optimize) {
+        start = std::chrono::steady_clock::now();
+        optimizeStats = MeshOptimizer::optimize(mesh);
+        optimizeMs = elapsedMs(start);
+    }
+
+    start = std::chrono::steady_clock::now();
+    if (!MeshCache::write(mesh, cachePath, objPath)) {
+        fprintf(stderr, "Failed to write cache: %s\n", cachePath.c_str());
+        return 1;
+    }
+    double writeMs = elapsedMs(start);
+
+    start = std::chrono::steady_clock::now();
+    Mesh cached;
+    if (!MeshCache::read(cachePath, cached, objPath)) {
+        fprintf(stderr, "Failed to read back cache: %s\n", cachePath.c_str());
+        return 1;
+    }
+    double readMs = elapsedMs(start);
+
+    printf("%s -> %s\n", objPath.c_str(), cachePath.c_str());
+    printf("Vertices:   %zu (%zu v, %zu vt, %zu vn records)\n", cached.getVertexCount(),
+           parseStats.positions, parseStats.texCoords, parseStats.normals);
+    printf("Triangles:  %zu from %zu faces (%zu skipped)\n", cached.getTriangleCount(),
+           parseStats.faces, parseStats.skippedFaces);
+    printf("Attributes: %s%s\n", cached.hasVertexNormals() ? "normals " : "",
+           cached.hasTexCoords() ? "texcoords" : "");
+    printf("OBJ parse:  %.3f ms (%.1f MB/s, %.2f M vertices/s, %zu chunks)\n", objMs,
+           parseStats.getMegabytesPerSecond(), parseStats.getVerticesPerSecond() / 1e6, parseStats.chunks);
+    if (optimize) {
+        printf("Optimize:   %.3f ms (%zu -> %zu vertices, ACMR %.3f -> %.3f)\n", optimizeMs,
+               optimizeStats.verticesBefore, optimizeStats.verticesAfter,
+               optimizeStats.acmrBefore, optimizeStats.acmrAfter);
+    }
+    printf("Cache write: %.3f ms\n", writeMs);
+    printf("Cache load: %.3f ms\n", readMs);
+    return 0;
+}